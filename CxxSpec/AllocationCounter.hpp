@@ -0,0 +1,306 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_ALLOCATIONCOUNTER_HPP
+#define CXXSPEC_ALLOCATIONCOUNTER_HPP
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace CxxSpec {
+
+struct AllocationStatistics
+{
+    std::size_t allocations;
+    std::size_t bytes;
+
+    friend AllocationStatistics operator-(const AllocationStatistics& left, const AllocationStatistics& right)
+    {
+        return { left.allocations - right.allocations, left.bytes - right.bytes };
+    }
+};
+
+struct AllocationSample
+{
+    static const int maxFrames = 16;
+
+    std::size_t size;
+    int depth;
+    void *frames[maxFrames];
+};
+
+typedef std::string (*StackSymbolizer)(void *const *frames, int depth);
+
+namespace Detail
+{
+
+const std::uint32_t threadSlotCount = 256;
+const std::uint32_t sharedThreadSlot = threadSlotCount - 1;
+const std::uint32_t untrackedBlock = 0xffffffff;
+const std::size_t samplesPerThread = 32;
+
+struct alignas(16) BlockHeader
+{
+    std::size_t size;
+    std::uint32_t slot;
+    std::int32_t sample;
+};
+
+struct SampleEntry
+{
+    std::atomic<void *> block;
+    std::size_t serial;
+    AllocationSample sample;
+};
+
+// Live allocation counters of one thread. Only the owning thread writes
+// the allocation and freed counters; other threads freeing its blocks
+// use the remotely freed ones. Only cross-thread frees need a locked
+// instruction.
+struct ThreadSlot
+{
+    std::atomic<std::size_t> allocations, bytes;
+    std::atomic<std::size_t> freedAllocations, freedBytes;
+    std::atomic<std::size_t> remotelyFreedAllocations, remotelyFreedBytes;
+    std::size_t nextSample;
+    SampleEntry samples[samplesPerThread];
+};
+
+struct ThreadAllocations
+{
+    AllocationStatistics counted;
+    int pauseDepth;
+    bool hasSlot;
+    std::uint32_t slot;
+    std::size_t sinceSample;
+};
+
+inline ThreadAllocations& threadAllocations()
+{
+    static thread_local ThreadAllocations allocations;
+    return allocations;
+}
+
+inline ThreadSlot *threadSlots()
+{
+    static ThreadSlot slots[threadSlotCount];
+    return slots;
+}
+
+inline std::atomic<std::uint32_t>& claimedThreadSlots()
+{
+    static std::atomic<std::uint32_t> claimed;
+    return claimed;
+}
+
+inline bool& allocationCountingEnabled()
+{
+    static bool enabled = false;
+    return enabled;
+}
+
+inline std::size_t& samplingInterval()
+{
+    static std::size_t interval = 64;
+    return interval;
+}
+
+inline StackSymbolizer& stackSymbolizer()
+{
+    static StackSymbolizer symbolizer = nullptr;
+    return symbolizer;
+}
+
+inline std::uint32_t threadSlot(ThreadAllocations& allocations)
+{
+    if (!allocations.hasSlot)
+    {
+        const std::uint32_t claimed = claimedThreadSlots().fetch_add(1, std::memory_order_relaxed);
+        allocations.slot = claimed < sharedThreadSlot ? claimed : sharedThreadSlot;
+        allocations.hasSlot = true;
+    }
+    return allocations.slot;
+}
+
+inline void addOwned(std::atomic<std::size_t>& counter, std::size_t value, std::uint32_t slot)
+{
+    if (slot == sharedThreadSlot)
+        counter.fetch_add(value, std::memory_order_relaxed);
+    else
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+}
+
+class AllocationCounter
+{
+public:
+    static bool isEnabled()
+    {
+        return Detail::allocationCountingEnabled();
+    }
+
+    static void enable()
+    {
+        Detail::allocationCountingEnabled() = true;
+    }
+
+    static void setSamplingInterval(std::size_t interval)
+    {
+        Detail::samplingInterval() = interval;
+    }
+
+    static void setStackSymbolizer(StackSymbolizer symbolizer)
+    {
+        Detail::stackSymbolizer() = symbolizer;
+    }
+
+    static AllocationStatistics current()
+    {
+        return Detail::threadAllocations().counted;
+    }
+
+    static AllocationStatistics live()
+    {
+        AllocationStatistics live = { 0, 0 };
+        const std::uint32_t claimed = Detail::claimedThreadSlots().load(std::memory_order_relaxed);
+        for (std::uint32_t i = 0; i != claimed && i != Detail::threadSlotCount; ++i)
+        {
+            const Detail::ThreadSlot& slot = Detail::threadSlots()[i];
+            live.allocations += slot.allocations.load(std::memory_order_relaxed) -
+                slot.freedAllocations.load(std::memory_order_relaxed) -
+                slot.remotelyFreedAllocations.load(std::memory_order_relaxed);
+            live.bytes += slot.bytes.load(std::memory_order_relaxed) -
+                slot.freedBytes.load(std::memory_order_relaxed) -
+                slot.remotelyFreedBytes.load(std::memory_order_relaxed);
+        }
+        return live;
+    }
+
+    static std::size_t serial()
+    {
+        Detail::ThreadAllocations& allocations = Detail::threadAllocations();
+        return Detail::threadSlots()[Detail::threadSlot(allocations)].allocations.load(std::memory_order_relaxed);
+    }
+
+    static std::vector<AllocationSample> liveSamplesSince(std::size_t serial)
+    {
+        std::vector<AllocationSample> samples;
+        const Detail::ThreadSlot& slot = Detail::threadSlots()[Detail::threadSlot(Detail::threadAllocations())];
+        for (const Detail::SampleEntry& entry : slot.samples)
+            if (entry.block.load(std::memory_order_acquire) && entry.serial >= serial)
+                samples.push_back(entry.sample);
+        return samples;
+    }
+
+    static bool allocated(Detail::BlockHeader& header, std::size_t size)
+    {
+        Detail::ThreadAllocations& allocations = Detail::threadAllocations();
+        header.size = size;
+        header.sample = -1;
+        if (allocations.pauseDepth)
+        {
+            header.slot = Detail::untrackedBlock;
+            return false;
+        }
+        ++allocations.counted.allocations;
+        allocations.counted.bytes += size;
+
+        header.slot = Detail::threadSlot(allocations);
+        Detail::ThreadSlot& slot = Detail::threadSlots()[header.slot];
+        Detail::addOwned(slot.allocations, 1, header.slot);
+        Detail::addOwned(slot.bytes, size, header.slot);
+
+        const std::size_t interval = Detail::samplingInterval();
+        if (interval == 0 || header.slot == Detail::sharedThreadSlot || ++allocations.sinceSample < interval)
+            return false;
+        allocations.sinceSample = 0;
+        return true;
+    }
+
+    static void sampled(Detail::BlockHeader& header, void *block, void *const *frames, int depth)
+    {
+        Detail::ThreadSlot& slot = Detail::threadSlots()[header.slot];
+        header.sample = std::int32_t(slot.nextSample++ % Detail::samplesPerThread);
+        Detail::SampleEntry& entry = slot.samples[header.sample];
+        entry.block.store(nullptr, std::memory_order_relaxed);
+        entry.serial = slot.allocations.load(std::memory_order_relaxed) - 1;
+        entry.sample.size = header.size;
+        if (depth > AllocationSample::maxFrames)
+            depth = AllocationSample::maxFrames;
+        entry.sample.depth = depth;
+        for (int i = 0; i != entry.sample.depth; ++i)
+            entry.sample.frames[i] = frames[i];
+        entry.block.store(block, std::memory_order_release);
+    }
+
+    static void freed(const Detail::BlockHeader& header, void *block)
+    {
+        if (header.slot == Detail::untrackedBlock)
+            return;
+        Detail::ThreadSlot& slot = Detail::threadSlots()[header.slot];
+        if (header.sample >= 0)
+        {
+            void *expected = block;
+            slot.samples[header.sample].block.compare_exchange_strong(expected, nullptr);
+        }
+        Detail::ThreadAllocations& allocations = Detail::threadAllocations();
+        if (allocations.hasSlot && allocations.slot == header.slot)
+        {
+            Detail::addOwned(slot.freedAllocations, 1, header.slot);
+            Detail::addOwned(slot.freedBytes, header.size, header.slot);
+        }
+        else
+        {
+            slot.remotelyFreedAllocations.fetch_add(1, std::memory_order_relaxed);
+            slot.remotelyFreedBytes.fetch_add(header.size, std::memory_order_relaxed);
+        }
+    }
+};
+
+class AllocationCountingPause
+{
+public:
+    AllocationCountingPause(const AllocationCountingPause& ) = delete;
+    AllocationCountingPause& operator=(const AllocationCountingPause& ) = delete;
+
+    AllocationCountingPause()
+    {
+        ++Detail::threadAllocations().pauseDepth;
+    }
+
+    ~AllocationCountingPause()
+    {
+        --Detail::threadAllocations().pauseDepth;
+    }
+};
+
+}
+
+#endif // CXXSPEC_ALLOCATIONCOUNTER_HPP
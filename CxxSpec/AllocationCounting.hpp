@@ -0,0 +1,170 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_ALLOCATIONCOUNTING_HPP
+#define CXXSPEC_ALLOCATIONCOUNTING_HPP
+#include <CxxSpec/AllocationCounter.hpp>
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+#include <execinfo.h>
+
+// Replaces the global operator new and delete with versions counting
+// allocations per thread and tracking live blocks for leak detection.
+// Include in exactly one translation unit.
+
+namespace CxxSpec {
+namespace Detail {
+
+inline void *countedAllocate(std::size_t size, bool nothrow)
+{
+    if (size > std::size_t(-1) - sizeof(BlockHeader))
+    {
+        if (nothrow)
+            return nullptr;
+        throw std::bad_alloc();
+    }
+    for (;;)
+    {
+        if (void *p = std::malloc(size + sizeof(BlockHeader)))
+        {
+            BlockHeader *header = static_cast<BlockHeader *>(p);
+            if (AllocationCounter::allocated(*header, size))
+            {
+                AllocationCountingPause pause;
+                void *frames[AllocationSample::maxFrames + 2];
+                const int depth = backtrace(frames, AllocationSample::maxFrames + 2);
+                if (depth > 2)
+                    AllocationCounter::sampled(*header, header + 1, frames + 2, depth - 2);
+            }
+            return header + 1;
+        }
+        std::new_handler handler = std::set_new_handler(nullptr);
+        std::set_new_handler(handler);
+        if (!handler)
+        {
+            if (nothrow)
+                return nullptr;
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+inline void countedFree(void *p)
+{
+    if (!p)
+        return;
+    BlockHeader *header = static_cast<BlockHeader *>(p) - 1;
+    AllocationCounter::freed(*header, p);
+    std::free(header);
+}
+
+inline std::string symbolizeStack(void *const *frames, int depth)
+{
+    std::string stack;
+    char **symbols = backtrace_symbols(frames, depth);
+    for (int i = 0; i != depth; ++i)
+    {
+        stack += "\n    ";
+        if (symbols)
+            stack += symbols[i];
+        else
+        {
+            char address[32];
+            std::snprintf(address, sizeof(address), "%p", frames[i]);
+            stack += address;
+        }
+    }
+    std::free(symbols);
+    return stack;
+}
+
+namespace
+{
+const bool allocationCountingEnabled =
+    (AllocationCounter::enable(), AllocationCounter::setStackSymbolizer(&symbolizeStack), true);
+}
+
+}
+}
+
+void *operator new(std::size_t size)
+{
+    return CxxSpec::Detail::countedAllocate(size, false);
+}
+
+void *operator new[](std::size_t size)
+{
+    return CxxSpec::Detail::countedAllocate(size, false);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t& ) noexcept
+{
+    try
+    {
+        return CxxSpec::Detail::countedAllocate(size, true);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t& ) noexcept
+{
+    try
+    {
+        return CxxSpec::Detail::countedAllocate(size, true);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete(void *p) noexcept
+{
+    CxxSpec::Detail::countedFree(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    CxxSpec::Detail::countedFree(p);
+}
+
+void operator delete(void *p, const std::nothrow_t& ) noexcept
+{
+    CxxSpec::Detail::countedFree(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t& ) noexcept
+{
+    CxxSpec::Detail::countedFree(p);
+}
+
+#endif // CXXSPEC_ALLOCATIONCOUNTING_HPP
@@ -29,10 +29,31 @@
 #define CXXSPEC_ASSERT_HPP
 #include <CxxSpec/Should.hpp>
 #include <sstream>
+#include <type_traits>
 
 namespace CxxSpec
 {
 
+namespace Detail
+{
+
+// Result type of the expression lambda. Named objects are referred to,
+// anything else is returned by value, since it may refer into a temporary
+// that dies when the lambda returns. A reference-typed name looks like any
+// other lvalue to decltype, so it is only referred to when it cannot be copied.
+template <typename Declared, typename Evaluated>
+struct ExpressionResult
+{
+    typedef typename std::decay<Evaluated>::type Value;
+    static const bool named =
+        !std::is_reference<Declared>::value && std::is_lvalue_reference<Evaluated>::value;
+    static const bool copyable = std::is_constructible<Value, Evaluated>::value;
+    typedef typename std::conditional<
+        named || (std::is_lvalue_reference<Evaluated>::value && !copyable), Evaluated, Value>::type type;
+};
+
+}
+
 template <typename Expression>
 class Expectation
 {
@@ -49,7 +70,7 @@ inline Expectation<Expression> makeExpectation(Expression expr, std::string file
     return Expectation<Expression>(expr, file, line, exprText);
 }
 
-#define CXXSPEC_EXPECT(expr) CxxSpec::makeExpectation([&]{ return expr; }, __FILE__, __LINE__, #expr)
+#define CXXSPEC_EXPECT(expr) CxxSpec::makeExpectation([&]() -> typename CxxSpec::Detail::ExpressionResult<decltype(expr), decltype((expr))>::type { return expr; }, __FILE__, __LINE__, #expr)
 
 }
 
@@ -27,26 +27,31 @@
 
 #ifndef CXXSPEC_ASSERTIONFAILED_HPP
 #define CXXSPEC_ASSERTIONFAILED_HPP
+#include <CxxSpec/Timing.hpp>
 #include <string>
 
 namespace CxxSpec {
 
+// Failure of an expectation. It carries the time it was raised at, since
+// reporters may only receive it after the specification finished.
 class AssertionFailed
 {
 public:
     AssertionFailed(const std::string& file, int line, const std::string& expression, const std::string& expectation = "")
-        : file_(file), line_(line), expression_(expression), expectation_(expectation) { }
+        : file_(file), line_(line), expression_(expression), expectation_(expectation), raised_(TimingClock::now()) { }
 
     std::string file() const { return file_; }
     int line() const { return line_; }
     std::string expression() const { return expression_; }
     std::string expectation() const { return expectation_; }
+    Timestamp raised() const { return raised_; }
 
 private:
     std::string file_;
     int line_;
     std::string expression_;
     std::string expectation_;
+    Timestamp raised_;
 };
 
 
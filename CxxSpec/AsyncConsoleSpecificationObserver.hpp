@@ -0,0 +1,254 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_ASYNCCONSOLESPECIFICATIONOBSERVER_HPP
+#define CXXSPEC_ASYNCCONSOLESPECIFICATIONOBSERVER_HPP
+#include <CxxSpec/ConsoleSpecificationObserver.hpp>
+#include <CxxSpec/AllocationCounter.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+// Single producer, single consumer byte queue. Positions grow without
+// wrapping; the capacity must be a power of two.
+class ByteRing
+{
+public:
+    explicit ByteRing(std::size_t capacity) : data(capacity), mask(capacity - 1), head(0), tail(0) { }
+
+    std::size_t capacity() const { return data.size(); }
+
+    std::size_t published() const { return head.load(std::memory_order_acquire); }
+
+    std::size_t consumed() const { return tail.load(std::memory_order_acquire); }
+
+    std::size_t push(const char *bytes, std::size_t size)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t space = data.size() - (h - tail.load(std::memory_order_acquire));
+        const std::size_t n = size < space ? size : space;
+        for (std::size_t i = 0; i != n; ++i)
+            data[(h + i) & mask] = bytes[i];
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    template <typename Sink>
+    std::size_t drain(Sink sink)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t h = head.load(std::memory_order_acquire);
+        if (h == t)
+            return 0;
+        const std::size_t begin = t & mask, end = h & mask;
+        if (begin < end)
+            sink(&data[begin], end - begin);
+        else
+        {
+            sink(&data[begin], data.size() - begin);
+            sink(&data[0], end);
+        }
+        tail.store(h, std::memory_order_release);
+        return h - t;
+    }
+
+private:
+    std::vector<char> data;
+    std::size_t mask;
+    std::atomic<std::size_t> head, tail;
+};
+
+}
+
+class AsyncConsoleSpecificationObserver : public ISpecificationObserver
+{
+public:
+    AsyncConsoleSpecificationObserver(
+        std::ostream& os,
+        std::chrono::milliseconds flushInterval = std::chrono::milliseconds(100),
+        std::size_t bufferSize = 1 << 20)
+        : os(os), flushInterval(flushInterval), ring(bufferSize), buffer(*this), stream(&buffer),
+        console(stream), stopping(false), drainRequested(false)
+    {
+        AllocationCountingPause pause;
+        writer = std::thread([this]{ write(); });
+    }
+
+    ~AsyncConsoleSpecificationObserver()
+    {
+        stream.flush();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeWriter.notify_one();
+        writer.join();
+    }
+
+    virtual void testFailed(const AssertionFailed& af)
+    {
+        console.testFailed(af);
+        flush();
+    }
+
+    virtual void testingSpecification(const std::string& spec)
+    {
+        console.testingSpecification(spec);
+    }
+
+    virtual void enteredContext(const std::string& context)
+    {
+        console.enteredContext(context);
+    }
+
+    virtual void leftContext()
+    {
+        console.leftContext();
+    }
+
+    virtual void specificationCached()
+    {
+        console.specificationCached();
+    }
+
+    virtual void specificationSkipped()
+    {
+        console.specificationSkipped();
+    }
+
+    virtual void finishedSpecification()
+    {
+        console.finishedSpecification();
+    }
+
+    void flush()
+    {
+        stream.flush();
+        const std::size_t target = ring.published();
+        std::unique_lock<std::mutex> lock(mutex);
+        drainRequested = true;
+        wakeWriter.notify_one();
+        written.wait(lock, [&]{ return ring.consumed() >= target; });
+    }
+
+private:
+    class RingBuffer : public std::streambuf
+    {
+    public:
+        explicit RingBuffer(AsyncConsoleSpecificationObserver& observer) : observer(observer) { }
+
+    protected:
+        virtual int overflow(int c)
+        {
+            if (c != traits_type::eof())
+                pending.push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+
+        virtual std::streamsize xsputn(const char *s, std::streamsize n)
+        {
+            pending.append(s, n);
+            return n;
+        }
+
+        virtual int sync()
+        {
+            observer.publish(pending);
+            pending.clear();
+            return 0;
+        }
+
+    private:
+        AsyncConsoleSpecificationObserver& observer;
+        std::string pending;
+    };
+
+    std::ostream& os;
+    std::chrono::milliseconds flushInterval;
+    Detail::ByteRing ring;
+    RingBuffer buffer;
+    std::ostream stream;
+    ConsoleSpecificationObserver console;
+    std::mutex mutex;
+    std::condition_variable wakeWriter, written;
+    bool stopping, drainRequested;
+    std::thread writer;
+
+    void publish(const std::string& text)
+    {
+        const char *bytes = text.data();
+        std::size_t size = text.size();
+        while (size)
+        {
+            const std::size_t pushed = ring.push(bytes, size);
+            bytes += pushed;
+            size -= pushed;
+            if (size)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    drainRequested = true;
+                }
+                wakeWriter.notify_one();
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void write()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            wakeWriter.wait_for(lock, flushInterval, [&]{ return stopping || drainRequested; });
+            const bool stop = stopping;
+            drainRequested = false;
+            lock.unlock();
+            if (ring.drain([&](const char *bytes, std::size_t size) { os.write(bytes, size); }))
+                os.flush();
+            lock.lock();
+            written.notify_all();
+            if (stop && ring.consumed() == ring.published())
+                return;
+        }
+    }
+};
+
+}
+
+#endif // CXXSPEC_ASYNCCONSOLESPECIFICATIONOBSERVER_HPP
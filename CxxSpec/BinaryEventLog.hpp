@@ -0,0 +1,530 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_BINARYEVENTLOG_HPP
+#define CXXSPEC_BINARYEVENTLOG_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/Timing.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+// A log is a header, a sequence of records and, when the writer was closed
+// properly, an index of string and specification offsets followed by a
+// trailer. Every record starts with a RecordHeader and is padded to eight
+// bytes, so the file can be mapped and read in place.
+const char eventLogMagic[8] = { 'C', 'X', 'S', 'P', 'L', 'O', 'G', '1' };
+const char eventLogIndexMagic[8] = { 'C', 'X', 'S', 'P', 'I', 'D', 'X', '1' };
+
+enum class RecordType : std::uint8_t
+{
+    String = 1, SpecificationStarted, ContextEntered, ContextLeft, Failure, SpecificationTimed, Allocations,
+    SectionTimed, LeafTimed
+};
+
+struct EventLogHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+struct RecordHeader
+{
+    RecordType type;
+    std::uint8_t reserved[3];
+    std::uint32_t value;
+};
+
+struct FailureRecord
+{
+    RecordHeader header;
+    std::int32_t line;
+    std::uint32_t expression;
+    std::uint32_t expectation;
+    std::uint32_t reserved;
+};
+
+struct IntervalRecord
+{
+    RecordHeader header;
+    std::uint64_t start;
+    std::uint64_t end;
+};
+
+struct SectionRecord
+{
+    RecordHeader header;
+    std::uint32_t entries;
+    std::uint32_t reserved;
+    std::uint64_t start;
+    std::uint64_t end;
+};
+
+struct AllocationsRecord
+{
+    RecordHeader header;
+    std::uint64_t allocations;
+    std::uint64_t bytes;
+};
+
+struct EventLogTrailer
+{
+    std::uint64_t eventsEnd;
+    std::uint64_t stringIndex;
+    std::uint64_t stringCount;
+    std::uint64_t specificationIndex;
+    std::uint64_t specificationCount;
+    char magic[8];
+};
+
+const std::uint32_t eventLogVersion = 2;
+
+inline std::size_t paddedRecordSize(std::size_t size)
+{
+    return (size + 7) & ~std::size_t(7);
+}
+
+inline std::uint64_t nanosecondsSinceEpoch(Timestamp timestamp)
+{
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count());
+}
+
+inline Timestamp timestampFromNanoseconds(std::uint64_t nanoseconds)
+{
+    return Timestamp(std::chrono::duration_cast<TimingClock::duration>(std::chrono::nanoseconds(nanoseconds)));
+}
+
+}
+
+// Appends the events to a stream as binary records. Strings are written
+// once and referenced by their number afterwards.
+class BinaryEventLogObserver : public ISpecificationObserver
+{
+public:
+    explicit BinaryEventLogObserver(std::ostream& os) : os(os), position(0)
+    {
+        Detail::EventLogHeader header = { { }, Detail::eventLogVersion, 0 };
+        std::memcpy(header.magic, Detail::eventLogMagic, sizeof(header.magic));
+        write(header);
+    }
+
+    ~BinaryEventLogObserver()
+    {
+        Detail::EventLogTrailer trailer = { position, 0, stringOffsets.size(), 0, specificationOffsets.size(), { } };
+        trailer.stringIndex = writeIndex(stringOffsets);
+        trailer.specificationIndex = writeIndex(specificationOffsets);
+        std::memcpy(trailer.magic, Detail::eventLogIndexMagic, sizeof(trailer.magic));
+        write(trailer);
+        os.flush();
+    }
+
+    virtual void testFailed(const AssertionFailed& af)
+    {
+        Detail::FailureRecord record = {
+            header(Detail::RecordType::Failure, intern(af.file())), af.line(),
+            intern(af.expression()), intern(af.expectation()), 0 };
+        write(record);
+    }
+
+    virtual void testingSpecification(const std::string& spec)
+    {
+        const std::uint32_t name = intern(spec);
+        specificationOffsets.push_back(position);
+        write(header(Detail::RecordType::SpecificationStarted, name));
+    }
+
+    virtual void enteredContext(const std::string& context)
+    {
+        write(header(Detail::RecordType::ContextEntered, intern(context)));
+    }
+
+    virtual void leftContext()
+    {
+        write(header(Detail::RecordType::ContextLeft, 0));
+    }
+
+    virtual void allocationsMeasured(const AllocationStatistics& allocated)
+    {
+        Detail::AllocationsRecord record = { header(Detail::RecordType::Allocations, 0), allocated.allocations, allocated.bytes };
+        write(record);
+    }
+
+    virtual void sectionTimed(const std::string& context, Timestamp start, Timestamp end, unsigned entries)
+    {
+        Detail::SectionRecord record = {
+            header(Detail::RecordType::SectionTimed, intern(context)), entries, 0,
+            Detail::nanosecondsSinceEpoch(start), Detail::nanosecondsSinceEpoch(end) };
+        write(record);
+    }
+
+    virtual void leafTimed(Timestamp start, Timestamp end)
+    {
+        writeInterval(header(Detail::RecordType::LeafTimed, 0), start, end);
+    }
+
+    virtual void specificationTimed(Timestamp start, Timestamp end, unsigned passes)
+    {
+        writeInterval(header(Detail::RecordType::SpecificationTimed, passes), start, end);
+    }
+
+private:
+
+    std::ostream& os;
+    std::uint64_t position;
+    std::unordered_map<std::string, std::uint32_t> strings;
+    std::vector<std::uint64_t> stringOffsets, specificationOffsets;
+
+    static Detail::RecordHeader header(Detail::RecordType type, std::uint32_t value)
+    {
+        Detail::RecordHeader header = { type, { }, value };
+        return header;
+    }
+
+    template <typename Record>
+    void write(const Record& record)
+    {
+        os.write(reinterpret_cast<const char *>(&record), sizeof(record));
+        position += sizeof(record);
+    }
+
+    std::uint32_t intern(const std::string& text)
+    {
+        auto it = strings.find(text);
+        if (it != strings.end())
+            return it->second;
+        const std::uint32_t id = std::uint32_t(stringOffsets.size());
+        strings.insert(std::make_pair(text, id));
+        stringOffsets.push_back(position);
+        write(header(Detail::RecordType::String, std::uint32_t(text.size())));
+        const std::size_t padded = Detail::paddedRecordSize(text.size());
+        os.write(text.data(), text.size());
+        os.write("\0\0\0\0\0\0\0", padded - text.size());
+        position += padded;
+        return id;
+    }
+
+    void writeInterval(Detail::RecordHeader header, Timestamp start, Timestamp end)
+    {
+        Detail::IntervalRecord record = {
+            header, Detail::nanosecondsSinceEpoch(start), Detail::nanosecondsSinceEpoch(end) };
+        write(record);
+    }
+
+    std::uint64_t writeIndex(const std::vector<std::uint64_t>& offsets)
+    {
+        const std::uint64_t indexPosition = position;
+        os.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+        position += offsets.size() * sizeof(std::uint64_t);
+        return indexPosition;
+    }
+};
+
+// Reads a log in place. Logs written by an observer that was destroyed
+// normally are indexed and nothing is parsed up front; logs cut short are
+// scanned once to recover the index. Replay stops at the first record that
+// is unknown or does not fit, and a corrupt index or string throws.
+class BinaryEventLog
+{
+public:
+    static const std::size_t all = std::size_t(-1);
+
+    BinaryEventLog(const char *data, std::size_t size) : data(data), eventsEnd(0), stringIndex(nullptr), specificationIndex(nullptr)
+    {
+        const Detail::EventLogHeader *header = at<Detail::EventLogHeader>(0, size);
+        if (!header || std::memcmp(header->magic, Detail::eventLogMagic, sizeof(header->magic)) != 0 || header->version != Detail::eventLogVersion)
+            throw std::runtime_error("not a CxxSpec event log");
+        if (!readIndex(size))
+            scan(size);
+    }
+
+    bool isIndexed() const
+    {
+        return specificationIndex && stringIndex;
+    }
+
+    std::size_t specificationCount() const
+    {
+        return specificationTotal;
+    }
+
+    std::string string(std::uint32_t id) const
+    {
+        if (id >= stringTotal)
+            throw std::out_of_range("string not in event log");
+        const std::uint64_t offset = stringIndex ? stringIndex[id] : scannedStrings[id];
+        const Detail::RecordHeader *header = at<Detail::RecordHeader>(offset, eventsEnd);
+        if (!header || header->type != Detail::RecordType::String || recordEnd(offset, eventsEnd) == offset)
+            throw std::runtime_error("corrupt CxxSpec event log");
+        return std::string(reinterpret_cast<const char *>(header + 1), header->value);
+    }
+
+    // Calls the visitor for every event of count specifications starting
+    // with the one numbered first.
+    template <typename Visitor>
+    void visit(Visitor& visitor, std::size_t first = 0, std::size_t count = all) const
+    {
+        if (first >= specificationTotal)
+            return;
+        const std::uint64_t begin = specificationOffset(first);
+        const std::uint64_t end = count < specificationTotal - first ? specificationOffset(first + count) : eventsEnd;
+        if (begin > end)
+            throw std::runtime_error("corrupt CxxSpec event log");
+        std::uint64_t offset = begin;
+        while (offset < end)
+        {
+            const std::uint64_t next = recordEnd(offset, end);
+            if (next == offset)
+                break;
+            const Detail::RecordHeader& header = *reinterpret_cast<const Detail::RecordHeader *>(data + offset);
+            switch (header.type)
+            {
+            case Detail::RecordType::String:
+                break;
+            case Detail::RecordType::SpecificationStarted:
+                visitor.specificationStarted(string(header.value));
+                break;
+            case Detail::RecordType::ContextEntered:
+                visitor.enteredContext(string(header.value));
+                break;
+            case Detail::RecordType::ContextLeft:
+                visitor.leftContext();
+                break;
+            case Detail::RecordType::Failure:
+            {
+                const Detail::FailureRecord& record = reinterpret_cast<const Detail::FailureRecord&>(header);
+                visitor.failed(AssertionFailed(
+                    string(header.value), record.line, string(record.expression), string(record.expectation)));
+                break;
+            }
+            case Detail::RecordType::SpecificationTimed:
+            {
+                const Detail::IntervalRecord& record = reinterpret_cast<const Detail::IntervalRecord&>(header);
+                visitor.specificationTimed(
+                    Detail::timestampFromNanoseconds(record.start), Detail::timestampFromNanoseconds(record.end), header.value);
+                break;
+            }
+            case Detail::RecordType::LeafTimed:
+            {
+                const Detail::IntervalRecord& record = reinterpret_cast<const Detail::IntervalRecord&>(header);
+                visitor.leafTimed(Detail::timestampFromNanoseconds(record.start), Detail::timestampFromNanoseconds(record.end));
+                break;
+            }
+            case Detail::RecordType::SectionTimed:
+            {
+                const Detail::SectionRecord& record = reinterpret_cast<const Detail::SectionRecord&>(header);
+                visitor.sectionTimed(string(header.value),
+                    Detail::timestampFromNanoseconds(record.start), Detail::timestampFromNanoseconds(record.end), record.entries);
+                break;
+            }
+            case Detail::RecordType::Allocations:
+            {
+                const Detail::AllocationsRecord& record = reinterpret_cast<const Detail::AllocationsRecord&>(header);
+                const AllocationStatistics allocated = { std::size_t(record.allocations), std::size_t(record.bytes) };
+                visitor.allocationsMeasured(allocated);
+                break;
+            }
+            }
+            offset = next;
+        }
+    }
+
+    void replay(ISpecificationObserver& observer, std::size_t first = 0, std::size_t count = all) const
+    {
+        ObserverVisitor visitor(observer);
+        visit(visitor, first, count);
+    }
+
+private:
+    struct ObserverVisitor
+    {
+        ISpecificationObserver& observer;
+
+        explicit ObserverVisitor(ISpecificationObserver& observer) : observer(observer) { }
+        void specificationStarted(const std::string& spec) { observer.testingSpecification(spec); }
+        void enteredContext(const std::string& context) { observer.enteredContext(context); }
+        void leftContext() { observer.leftContext(); }
+        void failed(const AssertionFailed& af) { observer.testFailed(af); }
+        void sectionTimed(const std::string& context, Timestamp start, Timestamp end, unsigned entries)
+        {
+            observer.sectionTimed(context, start, end, entries);
+        }
+        void leafTimed(Timestamp start, Timestamp end) { observer.leafTimed(start, end); }
+        void specificationTimed(Timestamp start, Timestamp end, unsigned passes) { observer.specificationTimed(start, end, passes); }
+        void allocationsMeasured(const AllocationStatistics& allocated) { observer.allocationsMeasured(allocated); }
+    };
+
+    const char *data;
+    std::uint64_t eventsEnd;
+    const std::uint64_t *stringIndex, *specificationIndex;
+    std::size_t stringTotal, specificationTotal;
+    std::vector<std::uint64_t> scannedStrings, scannedSpecifications;
+
+    template <typename T>
+    const T *at(std::uint64_t offset, std::uint64_t size) const
+    {
+        return offset <= size && sizeof(T) <= size - offset ? reinterpret_cast<const T *>(data + offset) : nullptr;
+    }
+
+    std::uint64_t specificationOffset(std::size_t n) const
+    {
+        const std::uint64_t offset = specificationIndex ? specificationIndex[n] : scannedSpecifications[n];
+        if (offset < sizeof(Detail::EventLogHeader) || offset > eventsEnd)
+            throw std::runtime_error("corrupt CxxSpec event log");
+        return offset;
+    }
+
+    // Gives the end of the record at offset, or offset itself when the
+    // record is unknown or does not end by limit.
+    std::uint64_t recordEnd(std::uint64_t offset, std::uint64_t limit) const
+    {
+        if (!at<Detail::RecordHeader>(offset, limit))
+            return offset;
+        const std::uint64_t size = recordSize(offset);
+        return size <= limit - offset ? offset + size : offset;
+    }
+
+    std::uint64_t recordSize(std::uint64_t offset) const
+    {
+        const Detail::RecordHeader& header = *reinterpret_cast<const Detail::RecordHeader *>(data + offset);
+        switch (header.type)
+        {
+        case Detail::RecordType::String:
+            return sizeof(Detail::RecordHeader) + Detail::paddedRecordSize(header.value);
+        case Detail::RecordType::SpecificationStarted:
+        case Detail::RecordType::ContextEntered:
+        case Detail::RecordType::ContextLeft:
+            return sizeof(Detail::RecordHeader);
+        case Detail::RecordType::Failure:
+            return sizeof(Detail::FailureRecord);
+        case Detail::RecordType::SpecificationTimed:
+        case Detail::RecordType::LeafTimed:
+            return sizeof(Detail::IntervalRecord);
+        case Detail::RecordType::SectionTimed:
+            return sizeof(Detail::SectionRecord);
+        case Detail::RecordType::Allocations:
+            return sizeof(Detail::AllocationsRecord);
+        }
+        return 0;
+    }
+
+    bool readIndex(std::uint64_t size)
+    {
+        if (size < sizeof(Detail::EventLogHeader) + sizeof(Detail::EventLogTrailer))
+            return false;
+        const Detail::EventLogTrailer& trailer =
+            *reinterpret_cast<const Detail::EventLogTrailer *>(data + size - sizeof(Detail::EventLogTrailer));
+        const std::uint64_t indexEnd = size - sizeof(Detail::EventLogTrailer);
+        if (std::memcmp(trailer.magic, Detail::eventLogIndexMagic, sizeof(trailer.magic)) != 0 ||
+            trailer.stringCount > size / sizeof(std::uint64_t) || trailer.specificationCount > size / sizeof(std::uint64_t) ||
+            trailer.eventsEnd > indexEnd ||
+            trailer.eventsEnd < sizeof(Detail::EventLogHeader) || trailer.stringIndex != trailer.eventsEnd ||
+            trailer.specificationIndex != trailer.stringIndex + trailer.stringCount * sizeof(std::uint64_t) ||
+            trailer.specificationIndex + trailer.specificationCount * sizeof(std::uint64_t) != indexEnd)
+            return false;
+        eventsEnd = trailer.eventsEnd;
+        stringIndex = reinterpret_cast<const std::uint64_t *>(data + trailer.stringIndex);
+        stringTotal = std::size_t(trailer.stringCount);
+        specificationIndex = reinterpret_cast<const std::uint64_t *>(data + trailer.specificationIndex);
+        specificationTotal = std::size_t(trailer.specificationCount);
+        return true;
+    }
+
+    void scan(std::uint64_t size)
+    {
+        std::uint64_t offset = sizeof(Detail::EventLogHeader);
+        while (const Detail::RecordHeader *header = at<Detail::RecordHeader>(offset, size))
+        {
+            const std::uint64_t next = recordEnd(offset, size);
+            if (next == offset)
+                break;
+            if (header->type == Detail::RecordType::String)
+                scannedStrings.push_back(offset);
+            else if (header->type == Detail::RecordType::SpecificationStarted)
+                scannedSpecifications.push_back(offset);
+            offset = next;
+        }
+        eventsEnd = offset;
+        stringTotal = scannedStrings.size();
+        specificationTotal = scannedSpecifications.size();
+    }
+};
+
+// Read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+    MappedFile(const MappedFile& ) = delete;
+    MappedFile& operator=(const MappedFile& ) = delete;
+
+    explicit MappedFile(const std::string& path) : data_(nullptr), size_(0)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("cannot open " + path);
+        struct stat status;
+        if (::fstat(fd, &status) == 0 && status.st_size > 0)
+        {
+            size_ = std::size_t(status.st_size);
+            void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            data_ = mapped == MAP_FAILED ? nullptr : static_cast<const char *>(mapped);
+        }
+        ::close(fd);
+        if (!data_)
+            throw std::runtime_error("cannot map " + path);
+    }
+
+    ~MappedFile()
+    {
+        ::munmap(const_cast<char *>(data_), size_);
+    }
+
+    const char *data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char *data_;
+    std::size_t size_;
+};
+
+}
+
+#endif // CXXSPEC_BINARYEVENTLOG_HPP
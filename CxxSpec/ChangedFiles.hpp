@@ -0,0 +1,199 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_CHANGEDFILES_HPP
+#define CXXSPEC_CHANGEDFILES_HPP
+#include <CxxSpec/SourceLocation.hpp>
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <istream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+inline std::string canonicalPath(const std::string& path)
+{
+    char resolved[PATH_MAX];
+    return ::realpath(path.c_str(), resolved) ? std::string(resolved) : path;
+}
+
+inline std::string shellQuoted(const std::string& argument)
+{
+    std::string quoted = "'";
+    for (char c : argument)
+        if (c == '\'')
+            quoted += "'\\''";
+        else
+            quoted += c;
+    return quoted + "'";
+}
+
+inline std::vector<std::string> commandOutputLines(const std::string& command)
+{
+    std::FILE *pipe = ::popen(command.c_str(), "r");
+    if (!pipe)
+        throw std::runtime_error("cannot run " + command);
+    std::vector<std::string> lines;
+    std::string line;
+    for (int c; (c = std::fgetc(pipe)) != EOF; )
+    {
+        if (c != '\n')
+            line += char(c);
+        else if (!line.empty())
+        {
+            lines.push_back(line);
+            line.clear();
+        }
+    }
+    if (!line.empty())
+        lines.push_back(line);
+    if (::pclose(pipe) != 0)
+        throw std::runtime_error("command failed: " + command);
+    return lines;
+}
+
+}
+
+// Files changed in a revision range of the git repository containing the
+// working directory, e.g. "origin/master..." or "HEAD" for the uncommitted
+// changes.
+inline std::vector<std::string> changedFilesInGitRange(const std::string& range)
+{
+    const std::vector<std::string> top = Detail::commandOutputLines("git rev-parse --show-toplevel");
+    if (top.empty())
+        throw std::runtime_error("not in a git repository");
+    std::vector<std::string> files;
+    for (const std::string& file : Detail::commandOutputLines("git diff --name-only " + Detail::shellQuoted(range) + " --"))
+        files.push_back(top.front() + "/" + file);
+    return files;
+}
+
+// Selects the specifications defined in changed files, or in source files
+// which, according to make-style dependency files as written by -MD,
+// include a changed header.
+class ChangedFileSelection
+{
+public:
+    ChangedFileSelection() { }
+
+    explicit ChangedFileSelection(const std::vector<std::string>& files)
+    {
+        for (const std::string& file : files)
+            changed.insert(Detail::canonicalPath(file));
+    }
+
+    void readDependencies(std::istream& rules)
+    {
+        std::vector<std::string> prerequisites;
+        std::string word;
+        bool targets = true;
+        for (char c; rules.get(c); )
+        {
+            if (c == '\\' && (rules.peek() == '\n' || rules.peek() == ' '))
+            {
+                rules.get(c);
+                if (c == ' ')
+                {
+                    word += c;
+                    continue;
+                }
+                c = ' ';
+            }
+            else if (c == ':' && targets && (rules.peek() == std::char_traits<char>::eof() || std::isspace(rules.peek())))
+            {
+                word.clear();
+                targets = false;
+                continue;
+            }
+            else if (c != ' ' && c != '\t' && c != '\n')
+            {
+                word += c;
+                continue;
+            }
+            if (!targets && !word.empty())
+                prerequisites.push_back(word);
+            word.clear();
+            if (c == '\n')
+            {
+                addRule(prerequisites);
+                prerequisites.clear();
+                targets = true;
+            }
+        }
+        if (!targets && !word.empty())
+            prerequisites.push_back(word);
+        addRule(prerequisites);
+    }
+
+    bool selects(const std::string& file) const
+    {
+        auto known = verdicts.find(file);
+        if (known != verdicts.end())
+            return known->second;
+        const std::string path = Detail::canonicalPath(file);
+        bool selected = changed.count(path) != 0;
+        auto rule = dependencies.find(path);
+        if (!selected && rule != dependencies.end())
+            for (const std::string& dependency : rule->second)
+                selected = selected || changed.count(dependency) != 0;
+        verdicts.insert(std::make_pair(file, selected));
+        return selected;
+    }
+
+    // Specifications registered without a source location are not selected.
+    bool operator()(const std::string& , const SourceLocation& location) const
+    {
+        return location.file && selects(location.file);
+    }
+
+private:
+    std::set<std::string> changed;
+    std::map<std::string, std::set<std::string>> dependencies;
+    mutable std::map<std::string, bool> verdicts;
+
+    void addRule(const std::vector<std::string>& prerequisites)
+    {
+        if (prerequisites.empty())
+            return;
+        std::set<std::string>& rule = dependencies[Detail::canonicalPath(prerequisites.front())];
+        for (const std::string& prerequisite : prerequisites)
+            rule.insert(Detail::canonicalPath(prerequisite));
+    }
+};
+
+}
+
+#endif // CXXSPEC_CHANGEDFILES_HPP
@@ -0,0 +1,138 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_CHROMETRACESPECIFICATIONOBSERVER_HPP
+#define CXXSPEC_CHROMETRACESPECIFICATIONOBSERVER_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/Json.hpp>
+#include <CxxSpec/LeafPath.hpp>
+#include <CxxSpec/ThreadId.hpp>
+#include <CxxSpec/Trace.hpp>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+// Writes the run in the Chrome trace event format. Specifications, passes
+// and sections become nested complete events on the thread that ran them,
+// failures become instant events. While the observer exists it also
+// receives the spans of CXXSPEC_TRACE_SPAN.
+class ChromeTraceSpecificationObserver : public Detail::LeafPathObserver, public ITraceSpanSink
+{
+public:
+    explicit ChromeTraceSpecificationObserver(std::ostream& os) : os(os), first(true), pid(::getpid())
+    {
+        os << "{\"traceEvents\":[";
+        Detail::traceSpanSink().store(this, std::memory_order_release);
+    }
+
+    ~ChromeTraceSpecificationObserver()
+    {
+        ITraceSpanSink *self = this;
+        Detail::traceSpanSink().compare_exchange_strong(self, nullptr);
+        std::lock_guard<std::mutex> lock(mutex);
+        os << "\n]}\n";
+        os.flush();
+    }
+
+    virtual void testFailed(const AssertionFailed& af)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        begin("i", "failure", af.expression(), af.raised());
+        os << ",\"s\":\"t\",\"args\":{\"expectation\":";
+        Detail::writeJsonString(os, af.expectation());
+        os << ",\"file\":";
+        Detail::writeJsonString(os, af.file());
+        os << ",\"line\":" << af.line() << "}}";
+    }
+
+    virtual void sectionTimed(const std::string& context, Timestamp start, Timestamp end, unsigned entries)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        complete("section", context, start, end);
+        os << ",\"args\":{\"entries\":" << entries << "}}";
+    }
+
+    virtual void specificationTimed(Timestamp start, Timestamp end, unsigned passes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        complete("specification", specification, start, end);
+        os << ",\"args\":{\"passes\":" << passes << "}}";
+    }
+
+    virtual void traceSpan(const char *name, Timestamp start, Timestamp end)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        complete("span", name, start, end);
+        os << "}";
+    }
+
+private:
+    std::ostream& os;
+    std::mutex mutex;
+    bool first;
+    const long pid;
+
+    virtual void leafFinished(Timestamp start, Timestamp end)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        complete("pass", leafPath.name(specification), start, end);
+        os << "}";
+    }
+
+    void writeMicroseconds(TimingClock::duration duration)
+    {
+        const long long nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        char micro[32];
+        std::snprintf(micro, sizeof(micro), "%lld.%03lld", nanoseconds / 1000, nanoseconds % 1000);
+        os << micro;
+    }
+
+    void begin(const char *phase, const char *category, const std::string& name, Timestamp timestamp)
+    {
+        os << (first ? "\n" : ",\n") << "{\"ph\":\"" << phase << "\",\"cat\":\"" << category << "\",\"name\":";
+        first = false;
+        Detail::writeJsonString(os, name);
+        os << ",\"pid\":" << pid << ",\"tid\":" << Detail::currentThreadId() << ",\"ts\":";
+        writeMicroseconds(timestamp.time_since_epoch());
+    }
+
+    void complete(const char *category, const std::string& name, Timestamp start, Timestamp end)
+    {
+        begin("X", category, name, start);
+        os << ",\"dur\":";
+        writeMicroseconds(end - start);
+    }
+};
+
+}
+
+#endif // CXXSPEC_CHROMETRACESPECIFICATIONOBSERVER_HPP
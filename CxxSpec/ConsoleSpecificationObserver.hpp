@@ -59,6 +59,14 @@ public:
     {
         --indent;
     }
+    virtual void specificationCached()
+    {
+        os << "    cached" << std::endl;
+    }
+    virtual void specificationSkipped()
+    {
+        os << "    skipped" << std::endl;
+    }
 private:
 
     class VisitiationHistory
@@ -0,0 +1,617 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_COVERAGE_HPP
+#define CXXSPEC_COVERAGE_HPP
+#include <CxxSpec/BinaryEventLog.hpp>
+#include <CxxSpec/ChangedFiles.hpp>
+#include <CxxSpec/ICoverageRecorder.hpp>
+#include <CxxSpec/ResultCache.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <link.h>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+// Functions entered while recording, in an open addressing table which is
+// filled without locks or allocation, since it is written from the
+// instrumentation hooks. Only the claimed slots are cleared after each
+// specification.
+struct FunctionTrace
+{
+    static const std::size_t capacity = 1 << 16;
+
+    std::uintptr_t slots[capacity];
+    std::uint32_t claimed[capacity];
+    std::uint32_t claimedCount;
+    bool overflowed;
+};
+
+// Only the thread running the recorded specification records, so
+// functions run meanwhile by other threads are not attributed to it.
+__attribute__((no_instrument_function)) inline bool& recordingThread()
+{
+    static thread_local bool recording = false;
+    return recording;
+}
+
+// Set by CxxSpec/CoverageHooks.hpp.
+inline bool& coverageHooksEnabled()
+{
+    static bool enabled = false;
+    return enabled;
+}
+
+__attribute__((no_instrument_function)) inline FunctionTrace& functionTrace()
+{
+    static FunctionTrace trace;
+    return trace;
+}
+
+// Called for every function entry of code compiled with
+// -finstrument-functions, so it calls no instrumented code.
+__attribute__((no_instrument_function)) inline void recordFunction(void *function)
+{
+    if (!recordingThread())
+        return;
+    FunctionTrace& trace = functionTrace();
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(function);
+    std::size_t slot = std::size_t((std::uint64_t(address) * 0x9E3779B97F4A7C15ull) >> 48);
+    for (std::size_t probe = 0; probe != FunctionTrace::capacity / 2; ++probe)
+    {
+        std::uintptr_t seen = __atomic_load_n(&trace.slots[slot], __ATOMIC_RELAXED);
+        if (seen == address)
+            return;
+        if (seen == 0)
+        {
+            if (__atomic_compare_exchange_n(&trace.slots[slot], &seen, address, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                trace.claimed[__atomic_fetch_add(&trace.claimedCount, 1, __ATOMIC_RELAXED)] = std::uint32_t(slot);
+                return;
+            }
+            if (seen == address)
+                return;
+        }
+        slot = (slot + 1) & (FunctionTrace::capacity - 1);
+    }
+    __atomic_store_n(&trace.overflowed, true, __ATOMIC_RELAXED);
+}
+
+// A coverage map is a header followed by the sorted file names, the
+// functions sorted by file and first line, the specifications, the
+// strings and the postings. The postings of a function are the indices
+// of the specifications which entered it, delta encoded as LEB128, so a
+// query reads only the postings of the changed functions.
+const char coverageMapMagic[8] = { 'C', 'X', 'S', 'P', 'C', 'O', 'V', '1' };
+
+struct CoverageMapHeader
+{
+    char magic[8];
+    std::uint32_t fileCount;
+    std::uint32_t functionCount;
+    std::uint32_t specificationCount;
+    std::uint32_t stringsSize;
+    std::uint64_t postingsSize;
+};
+
+struct CoveredFunction
+{
+    std::uint32_t file;
+    std::uint32_t line;
+    std::uint64_t postings;
+};
+
+struct CoveredSpecification
+{
+    std::uint32_t description;
+    std::uint32_t everything;
+};
+
+inline void appendVarint(std::string& out, std::uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out += char(value | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+
+inline bool isSourceFile(const std::string& path)
+{
+    static const char *const extensions[] = { ".c", ".cc", ".cpp", ".cxx", ".c++", ".h", ".hh", ".hpp", ".hxx", ".h++", ".ipp", ".inl", ".tcc" };
+    const std::string::size_type dot = path.find_last_of("./");
+    if (dot == std::string::npos || path[dot] != '.')
+        return false;
+    for (const char *extension : extensions)
+        if (path.compare(dot, std::string::npos, extension) == 0)
+            return true;
+    return false;
+}
+
+}
+
+// Lines of a file changed by a diff, numbered as in the revision the
+// coverage was recorded on.
+struct ChangedLines
+{
+    std::string file;
+    unsigned first, last;
+};
+
+// Reads the old side of the hunks of a unified diff, as written by
+// "git diff -U0". A hunk which only adds lines changes the lines around
+// the insertion. Paths are prefixed with root unless absolute.
+inline std::vector<ChangedLines> parseUnifiedDiff(const std::vector<std::string>& lines, const std::string& root = std::string())
+{
+    std::vector<ChangedLines> changes;
+    std::string file;
+    for (const std::string& line : lines)
+    {
+        if (line.compare(0, 4, "--- ") == 0)
+        {
+            file = line.substr(4, line.find('\t') - 4);
+            if (file == "/dev/null")
+                file.clear();
+            else if (file.compare(0, 2, "a/") == 0)
+                file.erase(0, 2);
+            if (!file.empty() && file[0] != '/' && !root.empty())
+                file = root + "/" + file;
+            continue;
+        }
+        unsigned first = 0, count = 1;
+        if (line.compare(0, 4, "@@ -") != 0 || file.empty())
+            continue;
+        const char *position = line.c_str() + 4;
+        char *end;
+        first = unsigned(std::strtoul(position, &end, 10));
+        if (*end == ',')
+            count = unsigned(std::strtoul(end + 1, &end, 10));
+        ChangedLines changed = { file, first, count == 0 ? first + 1 : first + count - 1 };
+        changes.push_back(changed);
+    }
+    return changes;
+}
+
+inline std::vector<ChangedLines> changedLinesInGitRange(const std::string& range)
+{
+    const std::vector<std::string> top = Detail::commandOutputLines("git rev-parse --show-toplevel");
+    if (top.empty())
+        throw std::runtime_error("not in a git repository");
+    return parseUnifiedDiff(
+        Detail::commandOutputLines("git diff -U0 --no-color " + Detail::shellQuoted(range) + " --"), top.front());
+}
+
+// Records the functions each specification enters and saves them as a
+// coverage map. Only functions compiled with -finstrument-functions are
+// seen; they are symbolized with addr2line, so they need debug
+// information. A specification entering more functions than the trace
+// holds, or none that could be symbolized, is recorded as depending on
+// everything. Only the functions entered on the thread which begins the
+// recording are seen, and one specification is recorded at a time. The
+// program has to include CxxSpec/CoverageHooks.hpp.
+class CoverageCollector : public ICoverageRecorder
+{
+public:
+    CoverageCollector(const CoverageCollector& ) = delete;
+    CoverageCollector& operator=(const CoverageCollector& ) = delete;
+
+    CoverageCollector()
+    {
+        if (!Detail::coverageHooksEnabled())
+            throw std::runtime_error("cannot record coverage without CxxSpec/CoverageHooks.hpp");
+    }
+
+    ~CoverageCollector()
+    {
+        Detail::recordingThread() = false;
+    }
+
+    virtual void begin()
+    {
+        Detail::recordingThread() = true;
+    }
+
+    virtual void end(const std::string& description)
+    {
+        Detail::recordingThread() = false;
+        Detail::FunctionTrace& trace = Detail::functionTrace();
+        Specification covered = { description, std::vector<std::uint32_t>(), trace.overflowed };
+        const std::uint32_t count = __atomic_load_n(&trace.claimedCount, __ATOMIC_RELAXED);
+        for (std::uint32_t i = 0; i != count; ++i)
+        {
+            std::uintptr_t& slot = trace.slots[trace.claimed[i]];
+            covered.functions.push_back(functionId(slot));
+            slot = 0;
+        }
+        trace.claimedCount = 0;
+        trace.overflowed = false;
+        std::sort(covered.functions.begin(), covered.functions.end());
+        specifications.push_back(covered);
+    }
+
+    void save(const std::string& path) const
+    {
+        std::vector<std::pair<std::string, unsigned>> locations = symbolize();
+        std::vector<std::string> files;
+        for (const auto& location : locations)
+            if (location.second != 0)
+                files.push_back(location.first);
+        std::sort(files.begin(), files.end());
+        files.erase(std::unique(files.begin(), files.end()), files.end());
+
+        std::string strings;
+        auto addString = [&](const std::string& text)
+        {
+            const std::uint32_t offset = std::uint32_t(strings.size());
+            strings.append(text.c_str(), text.size() + 1);
+            return offset;
+        };
+        std::vector<std::uint32_t> fileNames;
+        for (const std::string& file : files)
+            fileNames.push_back(addString(file));
+        std::vector<Detail::CoveredSpecification> specs;
+        for (const Specification& spec : specifications)
+        {
+            const bool symbolized = std::any_of(spec.functions.begin(), spec.functions.end(), [&](std::uint32_t function)
+            {
+                return locations[function].second != 0;
+            });
+            Detail::CoveredSpecification covered = { addString(spec.description), spec.everything || !symbolized };
+            specs.push_back(covered);
+        }
+
+        std::map<std::pair<std::uint32_t, unsigned>, std::vector<std::uint32_t>> postings;
+        for (std::uint32_t s = 0; s != specifications.size(); ++s)
+            for (std::uint32_t function : specifications[s].functions)
+            {
+                const auto& location = locations[function];
+                if (location.second == 0)
+                    continue;
+                const std::uint32_t file = std::uint32_t(std::lower_bound(files.begin(), files.end(), location.first) - files.begin());
+                std::vector<std::uint32_t>& list = postings[std::make_pair(file, location.second)];
+                if (list.empty() || list.back() != s)
+                    list.push_back(s);
+            }
+        std::vector<Detail::CoveredFunction> functions;
+        std::string encoded;
+        for (const auto& function : postings)
+        {
+            Detail::CoveredFunction covered = { function.first.first, function.first.second, encoded.size() };
+            functions.push_back(covered);
+            std::uint32_t previous = 0;
+            for (std::uint32_t s : function.second)
+            {
+                Detail::appendVarint(encoded, s - previous);
+                previous = s;
+            }
+        }
+
+        Detail::CoverageMapHeader header;
+        std::memcpy(header.magic, Detail::coverageMapMagic, sizeof(header.magic));
+        header.fileCount = std::uint32_t(files.size());
+        header.functionCount = std::uint32_t(functions.size());
+        header.specificationCount = std::uint32_t(specs.size());
+        header.stringsSize = std::uint32_t(strings.size());
+        header.postingsSize = encoded.size();
+        std::ofstream os(path.c_str(), std::ios::binary | std::ios::trunc);
+        os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char *>(fileNames.data()), fileNames.size() * sizeof(std::uint32_t));
+        if (fileNames.size() % 2)
+            os.write("\0\0\0\0", 4);
+        os.write(reinterpret_cast<const char *>(functions.data()), functions.size() * sizeof(Detail::CoveredFunction));
+        os.write(reinterpret_cast<const char *>(specs.data()), specs.size() * sizeof(Detail::CoveredSpecification));
+        os.write(strings.data(), strings.size());
+        os.write(encoded.data(), encoded.size());
+        if (!os.flush())
+            throw std::runtime_error("cannot write coverage map " + path);
+    }
+
+private:
+    struct Function
+    {
+        std::size_t module;
+        std::uintptr_t offset;
+    };
+
+    struct Specification
+    {
+        std::string description;
+        std::vector<std::uint32_t> functions;
+        bool everything;
+    };
+
+    std::vector<Detail::ModuleIdentity> moduleRanges;
+    std::vector<std::string> modules;
+    std::vector<Function> functions;
+    std::unordered_map<std::uintptr_t, std::uint32_t> functionIds;
+    std::vector<Specification> specifications;
+
+    // Addresses are resolved to module offsets while the modules are
+    // loaded, so a map can be saved after a library was unloaded.
+    std::uint32_t functionId(std::uintptr_t address)
+    {
+        auto known = functionIds.find(address);
+        if (known != functionIds.end())
+            return known->second;
+        std::size_t module = 0;
+        while (module != moduleRanges.size() && !(address >= moduleRanges[module].first && address < moduleRanges[module].last))
+            ++module;
+        if (module == moduleRanges.size())
+        {
+            Detail::ModuleIdentity range = { 0, 0, 0, 0 };
+            Detail::ModuleSearch search = { address, &range, nullptr, 0, false, false };
+            ::dl_iterate_phdr(&Detail::searchModule, &search);
+            moduleRanges.push_back(range);
+            modules.push_back(search.name && *search.name ? search.name : Detail::canonicalPath("/proc/self/exe"));
+        }
+        const Function function = { module, address - moduleRanges[module].bias };
+        const std::uint32_t id = std::uint32_t(functions.size());
+        functions.push_back(function);
+        functionIds.insert(std::make_pair(address, id));
+        return id;
+    }
+
+    // The canonical file and line of each function, or line 0 when it has
+    // no debug information.
+    std::vector<std::pair<std::string, unsigned>> symbolize() const
+    {
+        std::vector<std::pair<std::string, unsigned>> locations(functions.size(), std::make_pair(std::string(), 0u));
+        std::map<std::string, std::string> canonical;
+        for (std::size_t module = 0; module != modules.size(); ++module)
+        {
+            std::vector<std::uint32_t> ids;
+            char addresses[] = "/tmp/cxxspec-addresses-XXXXXX";
+            const int fd = ::mkstemp(addresses);
+            if (fd < 0)
+                throw std::runtime_error("cannot symbolize coverage");
+            ::close(fd);
+            {
+                std::ofstream os(addresses);
+                for (std::uint32_t id = 0; id != functions.size(); ++id)
+                    if (functions[id].module == module)
+                    {
+                        ids.push_back(id);
+                        os << std::hex << "0x" << functions[id].offset << "\n";
+                    }
+            }
+            std::vector<std::string> lines;
+            try
+            {
+                lines = Detail::commandOutputLines(
+                    "addr2line -e " + Detail::shellQuoted(modules[module]) + " < " + Detail::shellQuoted(addresses));
+            }
+            catch (...)
+            {
+                ::unlink(addresses);
+                throw;
+            }
+            ::unlink(addresses);
+            for (std::size_t i = 0; i != ids.size() && i != lines.size(); ++i)
+            {
+                const std::string::size_type colon = lines[i].find_last_of(':');
+                if (colon == std::string::npos || lines[i].compare(0, 2, "??") == 0)
+                    continue;
+                const std::string file = lines[i].substr(0, colon);
+                auto resolved = canonical.find(file);
+                if (resolved == canonical.end())
+                    resolved = canonical.insert(std::make_pair(file, Detail::canonicalPath(file))).first;
+                locations[ids[i]] = std::make_pair(resolved->second, unsigned(std::strtoul(lines[i].c_str() + colon + 1, nullptr, 10)));
+            }
+        }
+        return locations;
+    }
+};
+
+// Selects the specifications whose recorded coverage enters changed code,
+// and those which were not recorded. Functions are recorded at the line of
+// their opening brace. A changed line belongs to the function starting
+// closest above it in the same file, and to a function starting within a
+// few lines below it, whose signature it may be; lines above the first
+// function of a file, such as includes and declarations, belong to all its
+// functions. A change to a source file without any recorded
+// function selects every specification, as it may hold declarations or
+// macros used by the covered code.
+class CoverageImpact
+{
+public:
+    CoverageImpact() : everything(true) { }
+
+    CoverageImpact(const std::unordered_set<std::string>& recorded, const std::unordered_set<std::string>& selected, bool everything)
+        : recorded(recorded), selected(selected), everything(everything) { }
+
+    bool selects(const std::string& description) const
+    {
+        return everything || selected.count(description) != 0 || recorded.count(description) == 0;
+    }
+
+    bool operator()(const std::string& description, const SourceLocation& ) const
+    {
+        return selects(description);
+    }
+
+private:
+    std::unordered_set<std::string> recorded, selected;
+    bool everything;
+};
+
+// A saved coverage map, read in place. The sections must add up to the
+// size of the file, and the strings and postings are checked as they are
+// read, so a truncated or corrupt map throws instead of reading past it.
+class CoverageMap
+{
+public:
+    explicit CoverageMap(const std::string& path) : file(path)
+    {
+        if (file.size() < sizeof(Detail::CoverageMapHeader))
+            throw std::runtime_error("not a coverage map: " + path);
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, Detail::coverageMapMagic, sizeof(header.magic)) != 0)
+            throw std::runtime_error("not a coverage map: " + path);
+        const std::uint64_t filesSize = (std::uint64_t(header.fileCount) + header.fileCount % 2) * sizeof(std::uint32_t);
+        const std::uint64_t tablesSize = sizeof(header) + filesSize +
+            std::uint64_t(header.functionCount) * sizeof(Detail::CoveredFunction) +
+            std::uint64_t(header.specificationCount) * sizeof(Detail::CoveredSpecification) + header.stringsSize;
+        if (tablesSize > file.size() || header.postingsSize != file.size() - tablesSize)
+            throw std::runtime_error("corrupt coverage map: " + path);
+        fileNames = reinterpret_cast<const std::uint32_t *>(file.data() + sizeof(header));
+        functions = reinterpret_cast<const Detail::CoveredFunction *>(file.data() + sizeof(header) + filesSize);
+        specifications = reinterpret_cast<const Detail::CoveredSpecification *>(functions + header.functionCount);
+        strings = reinterpret_cast<const char *>(specifications + header.specificationCount);
+        postings = reinterpret_cast<const unsigned char *>(strings + header.stringsSize);
+        if (header.stringsSize != 0 && strings[header.stringsSize - 1] != '\0')
+            throw std::runtime_error("corrupt coverage map: " + path);
+    }
+
+    std::size_t specificationCount() const { return header.specificationCount; }
+
+    CoverageImpact impact(const std::vector<ChangedLines>& changes) const
+    {
+        std::vector<bool> selected(header.specificationCount, false);
+        for (const ChangedLines& change : changes)
+        {
+            const Detail::CoveredFunction *first, *last;
+            if (!functionsOf(Detail::canonicalPath(change.file), first, last))
+            {
+                if (Detail::isSourceFile(change.file))
+                    return CoverageImpact();
+                continue;
+            }
+            const Detail::CoveredFunction *from = std::upper_bound(first, last, change.first, [](unsigned line, const Detail::CoveredFunction& function)
+            {
+                return line < function.line;
+            });
+            const Detail::CoveredFunction *to = std::upper_bound(from, last, change.last + signatureLines, [](unsigned line, const Detail::CoveredFunction& function)
+            {
+                return line < function.line;
+            });
+            if (from == first)
+                to = last;
+            else
+                --from;
+            for (const Detail::CoveredFunction *function = from; function != to; ++function)
+                selectPostings(*function, selected);
+        }
+        std::unordered_set<std::string> recorded, impacted;
+        for (std::uint32_t s = 0; s != header.specificationCount; ++s)
+        {
+            const std::string description = stringAt(specifications[s].description);
+            recorded.insert(description);
+            if (selected[s] || specifications[s].everything)
+                impacted.insert(description);
+        }
+        return CoverageImpact(recorded, impacted, false);
+    }
+
+private:
+    static const unsigned signatureLines = 3;
+
+    MappedFile file;
+    Detail::CoverageMapHeader header;
+    const std::uint32_t *fileNames;
+    const Detail::CoveredFunction *functions;
+    const Detail::CoveredSpecification *specifications;
+    const char *strings;
+    const unsigned char *postings;
+
+    bool functionsOf(const std::string& path, const Detail::CoveredFunction *& first, const Detail::CoveredFunction *& last) const
+    {
+        const std::uint32_t *found = std::lower_bound(fileNames, fileNames + header.fileCount, path, [&](std::uint32_t name, const std::string& wanted)
+        {
+            return std::strcmp(stringAt(name), wanted.c_str()) < 0;
+        });
+        if (found == fileNames + header.fileCount || path != stringAt(*found))
+            return false;
+        const std::uint32_t index = std::uint32_t(found - fileNames);
+        first = std::lower_bound(functions, functions + header.functionCount, index, [](const Detail::CoveredFunction& function, std::uint32_t file)
+        {
+            return function.file < file;
+        });
+        last = std::upper_bound(first, functions + header.functionCount, index, [](std::uint32_t file, const Detail::CoveredFunction& function)
+        {
+            return file < function.file;
+        });
+        return first != last;
+    }
+
+    static std::runtime_error corrupt()
+    {
+        return std::runtime_error("corrupt coverage map");
+    }
+
+    const char *stringAt(std::uint32_t offset) const
+    {
+        if (offset >= header.stringsSize)
+            throw corrupt();
+        return strings + offset;
+    }
+
+    void selectPostings(const Detail::CoveredFunction& function, std::vector<bool>& selected) const
+    {
+        const std::uint64_t last = &function + 1 == functions + header.functionCount ?
+            header.postingsSize : (&function + 1)->postings;
+        if (function.postings > last || last > header.postingsSize)
+            throw corrupt();
+        const unsigned char *next = postings + function.postings;
+        const unsigned char *end = postings + last;
+        std::uint64_t s = 0;
+        while (next != end)
+        {
+            std::uint32_t delta = 0;
+            for (unsigned shift = 0; ; shift += 7)
+            {
+                if (next == end || shift > 28)
+                    throw corrupt();
+                const unsigned char byte = *next++;
+                delta |= std::uint32_t(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    break;
+            }
+            s += delta;
+            if (s >= header.specificationCount)
+                throw corrupt();
+            selected[std::size_t(s)] = true;
+        }
+    }
+};
+
+}
+
+#endif // CXXSPEC_COVERAGE_HPP
@@ -31,5 +31,6 @@
 #include <CxxSpec/Specification.hpp>
 #include <CxxSpec/Assert.hpp>
 #include <CxxSpec/SpecificationRegisterer.hpp>
+#include <CxxSpec/Trace.hpp>
 
 #endif // CXXSPEC_CXXSPEC_HPP
@@ -0,0 +1,318 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_DURATIONHISTORY_HPP
+#define CXXSPEC_DURATIONHISTORY_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/LeafPath.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+const char durationHistoryMagic[8] = { 'C', 'X', 'S', 'P', 'D', 'U', 'R', '1' };
+
+const unsigned maxOutcomes = 32;
+
+inline void writeHistoryInteger(std::string& out, std::uint64_t value, std::size_t size)
+{
+    for (std::size_t i = 0; i != size; ++i)
+        out += char((value >> (8 * i)) & 0xff);
+}
+
+inline void writeHistoryString(std::string& out, const std::string& text)
+{
+    writeHistoryInteger(out, text.size(), 4);
+    out += text;
+}
+
+// Reads the little endian fields written above, failing on truncation.
+class HistoryReader
+{
+public:
+    HistoryReader(const std::string& data, const std::string& path) : data(data), path(path), position(0) { }
+
+    std::uint64_t integer(std::size_t size)
+    {
+        need(size);
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i != size; ++i)
+            value |= std::uint64_t(static_cast<unsigned char>(data[position + i])) << (8 * i);
+        position += size;
+        return value;
+    }
+
+    std::string string()
+    {
+        const std::size_t size = std::size_t(integer(4));
+        need(size);
+        position += size;
+        return data.substr(position - size, size);
+    }
+
+    bool atEnd() const { return position == data.size(); }
+
+    void fail() const
+    {
+        throw std::runtime_error("not a duration history: " + path);
+    }
+
+private:
+    const std::string& data;
+    const std::string& path;
+    std::size_t position;
+
+    void need(std::size_t size) const
+    {
+        if (data.size() - position < size)
+            fail();
+    }
+};
+
+inline std::uint64_t nanosecondsBetween(Timestamp start, Timestamp end)
+{
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+}
+
+// The last measured durations of specifications and of their leaves, in
+// nanoseconds, and the outcomes of their last runs. Leaves are named by
+// their contexts joined with " / ".
+class DurationHistory
+{
+public:
+    struct Durations
+    {
+        std::uint64_t specification;
+        std::map<std::string, std::uint64_t> leaves;
+        // Bit n is set when the run n runs ago failed, for the last runs.
+        std::uint32_t failures;
+        unsigned runs;
+
+        Durations() : specification(0), failures(0), runs(0) { }
+    };
+
+    typedef std::map<std::string, Durations> Entries;
+
+    DurationHistory() : leafTotal(0), leafCount(0) { }
+
+    const Entries& entries() const { return entries_; }
+
+    void record(const std::string& spec, const Durations& durations)
+    {
+        Durations& recorded = entries_[spec];
+        forgetLeaves(recorded);
+        recorded = durations;
+        countLeaves(recorded);
+    }
+
+    // Takes the durations of the specifications in the newer history and
+    // appends its outcomes. The leaves which did not run in it, for example
+    // because only a failed leaf was run again, keep their durations.
+    void update(const DurationHistory& newer)
+    {
+        for (const auto& entry : newer.entries_)
+        {
+            Durations& durations = entries_[entry.first];
+            forgetLeaves(durations);
+            durations.specification = entry.second.specification;
+            for (const auto& leaf : entry.second.leaves)
+                durations.leaves[leaf.first] = leaf.second;
+            countLeaves(durations);
+            durations.failures = std::uint32_t((std::uint64_t(durations.failures) << entry.second.runs) | entry.second.failures);
+            durations.runs = std::min(durations.runs + entry.second.runs, Detail::maxOutcomes);
+        }
+    }
+
+    // A specification takes the longer of its last duration and the sum of
+    // its leaves, so a run of only some of its leaves does not make it look
+    // short. One without history is estimated from the mean duration of a
+    // leaf and the mean number of leaves of a specification; its own leaves
+    // are only found by running it. The totals behind the means are kept up
+    // to date, so an estimate does not look at other specifications.
+    std::uint64_t estimate(const std::string& spec) const
+    {
+        auto found = entries_.find(spec);
+        if (found != entries_.end())
+            return std::max(found->second.specification, sumOfLeaves(found->second));
+        if (leafCount == 0)
+            return 0;
+        const std::uint64_t meanLeaf = leafTotal / leafCount;
+        const std::uint64_t meanLeafCount = (leafCount + entries_.size() - 1) / entries_.size();
+        return meanLeaf * meanLeafCount;
+    }
+
+    // The history is a magic number followed by the specifications, each
+    // with its duration, outcomes and leaves, as little endian integers and
+    // length-prefixed strings. It is replaced by renaming.
+    void save(const std::string& path) const
+    {
+        std::string out(Detail::durationHistoryMagic, sizeof(Detail::durationHistoryMagic));
+        Detail::writeHistoryInteger(out, entries_.size(), 4);
+        for (const auto& entry : entries_)
+        {
+            Detail::writeHistoryString(out, entry.first);
+            Detail::writeHistoryInteger(out, entry.second.specification, 8);
+            Detail::writeHistoryInteger(out, entry.second.failures, 4);
+            Detail::writeHistoryInteger(out, entry.second.runs, 1);
+            Detail::writeHistoryInteger(out, entry.second.leaves.size(), 4);
+            for (const auto& leaf : entry.second.leaves)
+            {
+                Detail::writeHistoryString(out, leaf.first);
+                Detail::writeHistoryInteger(out, leaf.second, 8);
+            }
+        }
+        const std::string written = path + ".tmp";
+        {
+            std::ofstream os(written.c_str(), std::ios::binary | std::ios::trunc);
+            if (!os.write(out.data(), out.size()) || !os.flush())
+                throw std::runtime_error("cannot write " + written);
+        }
+        if (std::rename(written.c_str(), path.c_str()) != 0)
+            throw std::runtime_error("cannot replace " + path);
+    }
+
+    // A missing file is an empty history.
+    static DurationHistory load(const std::string& path)
+    {
+        DurationHistory history;
+        std::ifstream is(path.c_str(), std::ios::binary);
+        if (!is)
+            return history;
+        const std::string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        Detail::HistoryReader reader(data, path);
+        const std::size_t magicSize = sizeof(Detail::durationHistoryMagic);
+        if (data.size() < magicSize || std::memcmp(data.data(), Detail::durationHistoryMagic, magicSize) != 0)
+            reader.fail();
+        reader.integer(magicSize);
+        for (std::uint64_t specs = reader.integer(4); specs != 0; --specs)
+        {
+            const std::string spec = reader.string();
+            Durations durations;
+            durations.specification = reader.integer(8);
+            durations.failures = std::uint32_t(reader.integer(4));
+            durations.runs = std::min(unsigned(reader.integer(1)), Detail::maxOutcomes);
+            for (std::uint64_t leaves = reader.integer(4); leaves != 0; --leaves)
+            {
+                const std::string leaf = reader.string();
+                durations.leaves[leaf] = reader.integer(8);
+            }
+            history.record(spec, durations);
+        }
+        if (!reader.atEnd())
+            reader.fail();
+        return history;
+    }
+
+private:
+    Entries entries_;
+    std::uint64_t leafTotal, leafCount;
+
+    void countLeaves(const Durations& durations)
+    {
+        leafTotal += sumOfLeaves(durations);
+        leafCount += durations.leaves.size();
+    }
+
+    void forgetLeaves(const Durations& durations)
+    {
+        leafTotal -= sumOfLeaves(durations);
+        leafCount -= durations.leaves.size();
+    }
+
+    static std::uint64_t sumOfLeaves(const Durations& durations)
+    {
+        std::uint64_t sum = 0;
+        for (const auto& leaf : durations.leaves)
+            sum += leaf.second;
+        return sum;
+    }
+};
+
+// Records the durations and outcomes of the specifications which ran.
+// Cached and skipped specifications are not timed and keep their history.
+class DurationRecorder : public Detail::LeafPathObserver
+{
+public:
+    DurationRecorder() : timed(false) { }
+
+    virtual void testFailed(const AssertionFailed& )
+    {
+        durations.failures = 1;
+    }
+
+    virtual void testingSpecification(const std::string& spec)
+    {
+        LeafPathObserver::testingSpecification(spec);
+        durations = DurationHistory::Durations();
+        timed = false;
+    }
+
+    virtual void specificationTimed(Timestamp start, Timestamp end, unsigned )
+    {
+        durations.specification = Detail::nanosecondsBetween(start, end);
+        durations.runs = 1;
+        timed = true;
+    }
+
+    virtual void finishedSpecification()
+    {
+        if (timed)
+            recorded_.record(specification, durations);
+    }
+
+    const DurationHistory& recorded() const { return recorded_; }
+
+private:
+    DurationHistory recorded_;
+    DurationHistory::Durations durations;
+    bool timed;
+
+    virtual void leafFinished(Timestamp start, Timestamp end)
+    {
+        std::string leaf;
+        for (const std::string& context : leafPath.contexts())
+            leaf += (leaf.empty() ? "" : " / ") + context;
+        durations.leaves[leaf] += Detail::nanosecondsBetween(start, end);
+    }
+};
+
+}
+
+#endif // CXXSPEC_DURATIONHISTORY_HPP
@@ -0,0 +1,199 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_FAILEDLEAVES_HPP
+#define CXXSPEC_FAILEDLEAVES_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/LeafPath.hpp>
+#include <CxxSpec/RecordedLeaf.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CxxSpec {
+
+// Records the leaves which failed, the specifications which ran whole and
+// the leaves which ran on their own. Skipped specifications did not run.
+class FailedLeafRecorder : public Detail::LeafPathObserver
+{
+public:
+    FailedLeafRecorder() : firstRun(false), narrowed(false) { }
+
+    virtual void testFailed(const AssertionFailed& )
+    {
+        const RecordedLeaf leaf = { specification, leafPath.contexts() };
+        if (failed_.empty() || !(failed_.back() == leaf))
+            failed_.push_back(leaf);
+    }
+
+    virtual void testingSpecification(const std::string& spec)
+    {
+        LeafPathObserver::testingSpecification(spec);
+        firstRun = ran.insert(spec).second;
+        narrowed = false;
+    }
+
+    virtual void specificationSkipped()
+    {
+        forgetRun();
+    }
+
+    virtual void specificationNarrowedToLeaf()
+    {
+        forgetRun();
+        narrowed = true;
+    }
+
+    const RecordedLeaves& failed() const { return failed_; }
+
+    // The failures of this run, after the previous failures of the
+    // specifications which did not run whole and of the leaves which did
+    // not run on their own. A leaf run both on its own and with its
+    // specification is kept once.
+    RecordedLeaves merged(const RecordedLeaves& previous) const
+    {
+        RecordedLeaves leaves;
+        for (const RecordedLeaf& leaf : previous)
+            if (ran.count(leaf.specification) == 0 && std::find(ranLeaves.begin(), ranLeaves.end(), leaf) == ranLeaves.end())
+                leaves.push_back(leaf);
+        for (const RecordedLeaf& leaf : failed_)
+            if (std::find(leaves.begin(), leaves.end(), leaf) == leaves.end())
+                leaves.push_back(leaf);
+        return leaves;
+    }
+
+private:
+    RecordedLeaves failed_, ranLeaves;
+    std::set<std::string> ran;
+    bool firstRun, narrowed;
+
+    virtual void leafFinished(Timestamp , Timestamp )
+    {
+        if (narrowed)
+        {
+            const RecordedLeaf leaf = { specification, leafPath.contexts() };
+            ranLeaves.push_back(leaf);
+        }
+    }
+
+    void forgetRun()
+    {
+        if (firstRun)
+            ran.erase(specification);
+        firstRun = false;
+    }
+};
+
+namespace Detail
+{
+
+inline void writeLeafField(std::ostream& os, const std::string& field)
+{
+    for (char c : field)
+    {
+        switch (c)
+        {
+        case '\\': os << "\\\\"; break;
+        case '\t': os << "\\t"; break;
+        case '\n': os << "\\n"; break;
+        default: os << c;
+        }
+    }
+}
+
+inline std::vector<std::string> readLeafFields(const std::string& line)
+{
+    std::vector<std::string> fields(1);
+    for (std::string::size_type i = 0; i != line.size(); ++i)
+    {
+        if (line[i] == '\t')
+            fields.push_back(std::string());
+        else if (line[i] == '\\' && i + 1 != line.size())
+        {
+            ++i;
+            fields.back() += line[i] == 't' ? '\t' : line[i] == 'n' ? '\n' : line[i];
+        }
+        else
+            fields.back() += line[i];
+    }
+    return fields;
+}
+
+}
+
+// The leaves are stored one per line, with the specification and its
+// contexts separated by tabs. The file is replaced by renaming, so an
+// interrupted run leaves the previous failures.
+inline void saveFailedLeaves(const std::string& path, const RecordedLeaves& leaves)
+{
+    const std::string written = path + ".tmp";
+    {
+        std::ofstream os(written.c_str(), std::ios::trunc);
+        if (!os)
+            throw std::runtime_error("cannot write " + written);
+        for (const RecordedLeaf& leaf : leaves)
+        {
+            Detail::writeLeafField(os, leaf.specification);
+            for (const std::string& context : leaf.contexts)
+            {
+                os << '\t';
+                Detail::writeLeafField(os, context);
+            }
+            os << '\n';
+        }
+        if (!os.flush())
+            throw std::runtime_error("cannot write " + written);
+    }
+    if (std::rename(written.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("cannot replace " + path);
+}
+
+// A missing file holds no failures.
+inline RecordedLeaves loadFailedLeaves(const std::string& path)
+{
+    RecordedLeaves leaves;
+    std::ifstream is(path.c_str());
+    for (std::string line; std::getline(is, line); )
+    {
+        if (line.empty())
+            continue;
+        std::vector<std::string> fields = Detail::readLeafFields(line);
+        RecordedLeaf leaf;
+        leaf.specification = fields.front();
+        leaf.contexts.assign(fields.begin() + 1, fields.end());
+        leaves.push_back(leaf);
+    }
+    return leaves;
+}
+
+}
+
+#endif // CXXSPEC_FAILEDLEAVES_HPP
@@ -0,0 +1,164 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_FILEWATCHER_HPP
+#define CXXSPEC_FILEWATCHER_HPP
+#include <CxxSpec/ChangedFiles.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+// Reports changed files using inotify. Directories are watched with their
+// subdirectories, including those created later. A single file is watched
+// through its directory, so that replacing it, as linkers and editors do,
+// is seen as well as writing to it.
+class FileWatcher
+{
+public:
+    FileWatcher(const FileWatcher& ) = delete;
+    FileWatcher& operator=(const FileWatcher& ) = delete;
+
+    FileWatcher() : fd(::inotify_init1(IN_CLOEXEC | IN_NONBLOCK))
+    {
+        if (fd < 0)
+            throw std::runtime_error(std::string("inotify: ") + std::strerror(errno));
+    }
+
+    ~FileWatcher()
+    {
+        ::close(fd);
+    }
+
+    void watchDirectory(const std::string& path)
+    {
+        const std::string directory = Detail::canonicalPath(path);
+        watches[addWatch(directory)].recursive = true;
+        DIR *entries = ::opendir(directory.c_str());
+        if (!entries)
+            return;
+        while (const dirent *entry = ::readdir(entries))
+        {
+            const std::string name = entry->d_name;
+            if (entry->d_type == DT_DIR && name != "." && name != "..")
+                watchDirectory(directory + "/" + name);
+        }
+        ::closedir(entries);
+    }
+
+    void watchFile(const std::string& path)
+    {
+        const std::string file = Detail::canonicalPath(path);
+        const std::string::size_type slash = file.find_last_of('/');
+        const std::string directory = slash == 0 ? "/" : file.substr(0, slash);
+        watches[addWatch(directory)].files.insert(file.substr(slash + 1));
+    }
+
+    // Blocks until a watched file changes and then until nothing has
+    // changed for the quiet period, so that the files written by one
+    // build or one save are reported together. Paths are canonical.
+    std::vector<std::string> waitForChanges(std::chrono::milliseconds quietPeriod)
+    {
+        std::set<std::string> changed;
+        for (;;)
+        {
+            pollfd ready = { fd, POLLIN, 0 };
+            const int timeout = changed.empty() ? -1 : int(quietPeriod.count());
+            const int polled = ::poll(&ready, 1, timeout);
+            if (polled < 0 && errno != EINTR)
+                throw std::runtime_error(std::string("poll: ") + std::strerror(errno));
+            if (polled == 0)
+                return std::vector<std::string>(changed.begin(), changed.end());
+            if (polled > 0)
+                readEvents(changed);
+        }
+    }
+
+private:
+    struct Watch
+    {
+        std::string directory;
+        bool recursive;
+        std::set<std::string> files;
+
+        Watch() : recursive(false) { }
+    };
+
+    int fd;
+    std::map<int, Watch> watches;
+
+    int addWatch(const std::string& directory)
+    {
+        const int wd = ::inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+        if (wd < 0)
+            throw std::runtime_error("cannot watch " + directory + ": " + std::strerror(errno));
+        watches[wd].directory = directory;
+        return wd;
+    }
+
+    void readEvents(std::set<std::string>& changed)
+    {
+        alignas(inotify_event) char buffer[4096];
+        for (;;)
+        {
+            const ssize_t length = ::read(fd, buffer, sizeof(buffer));
+            if (length <= 0)
+                return;
+            for (const char *next = buffer; next < buffer + length; )
+            {
+                const inotify_event *event = reinterpret_cast<const inotify_event *>(next);
+                next += sizeof(inotify_event) + event->len;
+                auto watch = watches.find(event->wd);
+                if (watch == watches.end() || event->len == 0)
+                    continue;
+                const std::string name = event->name;
+                const std::string path = watch->second.directory + "/" + name;
+                if ((event->mask & IN_ISDIR) != 0)
+                {
+                    if (watch->second.recursive && (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+                        watchDirectory(path);
+                }
+                else if (watch->second.recursive || watch->second.files.count(name) != 0)
+                    changed.insert(path);
+            }
+        }
+    }
+};
+
+}
+
+#endif // CXXSPEC_FILEWATCHER_HPP
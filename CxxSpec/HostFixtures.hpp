@@ -0,0 +1,106 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_HOSTFIXTURES_HPP
+#define CXXSPEC_HOSTFIXTURES_HPP
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+
+namespace CxxSpec {
+
+// Fixtures created by a long-lived host process and lent to the
+// specification libraries it loads. They are created and destroyed by host
+// code, so they outlive any reload of the libraries using them.
+class HostFixtures
+{
+public:
+    template <typename T>
+    void provide(const std::string& name, std::shared_ptr<T> fixture)
+    {
+        Fixture& provided = fixtures[name];
+        provided.type = typeid(T).name();
+        provided.object = fixture;
+    }
+
+    template <typename T>
+    std::shared_ptr<T> get(const std::string& name) const
+    {
+        auto found = fixtures.find(name);
+        if (found == fixtures.end())
+            throw std::out_of_range("no host fixture " + name);
+        if (found->second.type != typeid(T).name())
+            throw std::logic_error("host fixture " + name + " has type " + found->second.type);
+        return std::static_pointer_cast<T>(found->second.object);
+    }
+
+private:
+    struct Fixture
+    {
+        std::string type;
+        std::shared_ptr<void> object;
+    };
+
+    std::map<std::string, Fixture> fixtures;
+};
+
+namespace Detail
+{
+
+// Hidden, so that each library sees the fixtures of the host attaching it.
+__attribute__((visibility("hidden"))) inline HostFixtures *& attachedHostFixtures()
+{
+    static HostFixtures *fixtures = nullptr;
+    return fixtures;
+}
+
+}
+
+// A fixture of the host which loaded the calling specification library.
+// Keep no copy beyond a run, so the host decides when the fixture dies.
+template <typename T>
+std::shared_ptr<T> hostFixture(const std::string& name)
+{
+    const HostFixtures *fixtures = Detail::attachedHostFixtures();
+    if (!fixtures)
+        throw std::logic_error("no specification host provides " + name);
+    return fixtures->get<T>(name);
+}
+
+}
+
+#ifdef CXXSPEC_USE_SECTION_REGISTRATION
+// Lets SpecificationHost attach its fixtures to a library using them.
+extern "C" __attribute__((weak, visibility("default"))) void cxxspec_attachHostFixtures(::CxxSpec::HostFixtures *fixtures)
+{
+    ::CxxSpec::Detail::attachedHostFixtures() = fixtures;
+}
+#endif
+
+#endif // CXXSPEC_HOSTFIXTURES_HPP
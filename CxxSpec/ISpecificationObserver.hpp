@@ -28,6 +28,10 @@
 #ifndef CXXSPEC_ISPECIFICATIONOBSERVER_HPP
 #define CXXSPEC_ISPECIFICATIONOBSERVER_HPP
 #include <CxxSpec/AssertionFailed.hpp>
+#include <CxxSpec/AllocationCounter.hpp>
+#include <CxxSpec/PerformanceCounters.hpp>
+#include <CxxSpec/SourceLocation.hpp>
+#include <CxxSpec/Timing.hpp>
 
 namespace CxxSpec {
 
@@ -39,6 +43,19 @@ public:
     virtual void testingSpecification(const std::string& spec) = 0;
     virtual void enteredContext(const std::string& context) = 0;
     virtual void leftContext() = 0;
+    virtual void allocationsMeasured(const AllocationStatistics& ) { }
+    virtual void finishedSpecification() { }
+    virtual void finishedRun() { }
+    virtual void sectionTimed(const std::string& context, Timestamp start, Timestamp end, unsigned entries) { }
+    virtual void leafTimed(Timestamp start, Timestamp end) { }
+    virtual void specificationTimed(Timestamp start, Timestamp end, unsigned passes) { }
+    virtual void leafCountersMeasured(const PerformanceCounters& ) { }
+    virtual void specificationCountersMeasured(const PerformanceCounters& ) { }
+    virtual void specificationCached() { }
+    virtual void specificationSkipped() { }
+    virtual void specificationNarrowedToLeaf() { }
+    virtual void testingSpecificationAt(const std::string& spec, const SourceLocation& ) { testingSpecification(spec); }
+    virtual void enteredContextAt(const std::string& context, const SourceLocation& ) { enteredContext(context); }
 };
 
 }
@@ -27,9 +27,12 @@
 
 #ifndef CXXSPEC_ISPECIFICATIONVISITOR_HPP
 #define CXXSPEC_ISPECIFICATIONVISITOR_HPP
+#include <CxxSpec/SourceLocation.hpp>
+#include <CxxSpec/Tags.hpp>
 #include <string>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace CxxSpec {
 
@@ -43,6 +46,10 @@ public:
     virtual void endSection() = 0;
     virtual bool done() const = 0;
     virtual void caughtException() = 0;
+    virtual void beginTaggedSpecification(const TagSet& ) { beginSpecification(); }
+    virtual bool beginSectionAt(const std::string& desc, const TagSet& , const SourceLocation& ) { return beginSection(desc); }
+    virtual void selectTags(const TagQuery& ) { }
+    virtual void selectPath(const std::vector<std::string>& ) { }
 };
 
 typedef std::function<std::shared_ptr<ISpecificationVisitor>()> ISpecificationVisitorFactory;
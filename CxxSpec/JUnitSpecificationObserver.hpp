@@ -0,0 +1,275 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_JUNITSPECIFICATIONOBSERVER_HPP
+#define CXXSPEC_JUNITSPECIFICATIONOBSERVER_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <chrono>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace CxxSpec {
+
+// Writes JUnit XML while the specifications run. Every leaf path becomes a
+// testcase and every specification a testsuite. Testcases are timed by
+// leafTimed, or between passes when that is not reported. Only the open
+// path and the current testcase are kept in memory. A failure reported
+// after specificationTimed, like a leak, becomes a testcase named after
+// the specification. When the stream is seekable the totals are patched
+// into the root element at the end.
+class JUnitSpecificationObserver : public ISpecificationObserver
+{
+public:
+    explicit JUnitSpecificationObserver(std::ostream& os)
+        : os(os), inSpecification(false), leaving(false), pending(false), specificationHasTestcases(false), passesFinished(false),
+        testcases(0), failures(0), started(Clock::now())
+    {
+        os << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites";
+        totalsPosition = os.tellp();
+        if (totalsPosition != std::streampos(-1))
+            os << std::string(totalsWidth, ' ');
+        os << ">\n";
+    }
+
+    ~JUnitSpecificationObserver()
+    {
+        closeSpecification();
+        os << "</testsuites>\n";
+        if (totalsPosition == std::streampos(-1))
+            return;
+        std::ostringstream totals;
+        totals << " tests=\"" << testcases << "\" failures=\"" << failures << "\" time=\"" << secondsSince(started) << "\"";
+        if (totals.str().size() > totalsWidth)
+            return;
+        os.flush();
+        const std::streampos end = os.tellp();
+        if (end == std::streampos(-1) || !os.seekp(totalsPosition) || os.tellp() != totalsPosition)
+        {
+            os.clear();
+            return;
+        }
+        os << totals.str();
+        os.seekp(end);
+        os.flush();
+    }
+
+    virtual void testFailed(const AssertionFailed& af)
+    {
+        if (passesFinished)
+        {
+            closeTestcase();
+            openTestcase(specification);
+        }
+        else if (!pending)
+        {
+            openTestcase(path.empty() ? specification : joinedPath());
+            leaving = true;
+        }
+        failed = true;
+        failureMessage = af.expression() + " " + af.expectation();
+        std::ostringstream location;
+        location << "At " << af.file() << ":" << af.line();
+        failureLocation = location.str();
+    }
+
+    virtual void testingSpecification(const std::string& spec)
+    {
+        closeSpecification();
+        specification = spec;
+        inSpecification = true;
+        specificationHasTestcases = false;
+        passesFinished = false;
+        passStarted = Clock::now();
+        os << "  <testsuite name=\"";
+        writeEscaped(spec);
+        os << "\">\n";
+    }
+
+    virtual void enteredContext(const std::string& context)
+    {
+        if (leaving)
+        {
+            closeTestcase();
+            leaving = false;
+        }
+        path.push_back(context);
+    }
+
+    virtual void leftContext()
+    {
+        if (!leaving)
+        {
+            openTestcase(joinedPath());
+            leaving = true;
+        }
+        if (!path.empty())
+            path.pop_back();
+    }
+
+    virtual void leafTimed(Timestamp start, Timestamp end)
+    {
+        if (!pending)
+        {
+            openTestcase(path.empty() ? specification : joinedPath());
+            leaving = true;
+        }
+        testcaseDuration = end - start;
+        timed = true;
+    }
+
+    virtual void specificationTimed(Timestamp , Timestamp , unsigned )
+    {
+        if (!inSpecification)
+            return;
+        if (!pending && !specificationHasTestcases)
+            openTestcase(specification);
+        closeTestcase();
+        passesFinished = true;
+    }
+
+    virtual void finishedSpecification()
+    {
+        closeSpecification();
+    }
+
+private:
+    typedef TimingClock Clock;
+
+    static const std::size_t totalsWidth = 96;
+
+    std::ostream& os;
+    std::streampos totalsPosition;
+    std::string specification;
+    std::vector<std::string> path;
+    bool inSpecification, leaving, pending, specificationHasTestcases, passesFinished;
+    std::string testcaseName;
+    Clock::time_point passStarted, testcaseEnded;
+    Clock::duration testcaseDuration;
+    bool timed, failed;
+    std::string failureMessage, failureLocation;
+    std::size_t testcases, failures;
+    Clock::time_point started;
+
+    static double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::string joinedPath() const
+    {
+        std::string joined;
+        for (const std::string& context : path)
+        {
+            if (!joined.empty())
+                joined += " / ";
+            joined += context;
+        }
+        return joined;
+    }
+
+    void openTestcase(const std::string& name)
+    {
+        testcaseName = name;
+        testcaseEnded = Clock::now();
+        timed = false;
+        failed = false;
+        pending = true;
+    }
+
+    void closeTestcase()
+    {
+        if (!pending)
+            return;
+        pending = false;
+        specificationHasTestcases = true;
+        ++testcases;
+        os << "    <testcase classname=\"";
+        writeEscaped(specification);
+        os << "\" name=\"";
+        writeEscaped(testcaseName);
+        os << "\" time=\"" << std::chrono::duration<double>(timed ? testcaseDuration : testcaseEnded - passStarted).count() << "\"";
+        passStarted = Clock::now();
+        if (!failed)
+        {
+            os << "/>\n";
+            return;
+        }
+        ++failures;
+        os << ">\n      <failure message=\"";
+        writeEscaped(failureMessage);
+        os << "\" type=\"AssertionFailed\">";
+        writeEscaped(failureLocation);
+        os << "</failure>\n    </testcase>\n";
+    }
+
+    void closeSpecification()
+    {
+        if (!inSpecification)
+            return;
+        if (!pending && !specificationHasTestcases)
+            openTestcase(specification);
+        closeTestcase();
+        os << "  </testsuite>\n";
+        inSpecification = false;
+        leaving = false;
+        path.clear();
+    }
+
+    void writeEscaped(const std::string& text)
+    {
+        const char *begin = text.data(), *end = begin + text.size();
+        for (const char *c = begin; c != end; ++c)
+        {
+            const char *replacement;
+            switch (*c)
+            {
+            case '&': replacement = "&amp;"; break;
+            case '<': replacement = "&lt;"; break;
+            case '>': replacement = "&gt;"; break;
+            case '"': replacement = "&quot;"; break;
+            case '\'': replacement = "&apos;"; break;
+            case '\n': replacement = "&#10;"; break;
+            case '\t': replacement = "&#9;"; break;
+            case '\r': replacement = "&#13;"; break;
+            default:
+                if (static_cast<unsigned char>(*c) >= 0x20)
+                    continue;
+                replacement = "?";
+            }
+            os.write(begin, c - begin);
+            os << replacement;
+            begin = c + 1;
+        }
+        os.write(begin, end - begin);
+    }
+};
+
+}
+
+#endif // CXXSPEC_JUNITSPECIFICATIONOBSERVER_HPP
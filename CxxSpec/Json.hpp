@@ -0,0 +1,80 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_JSON_HPP
+#define CXXSPEC_JSON_HPP
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+// Passes the JSON escaped form of text to sink(const char *, size_t),
+// copying runs of characters that need no escaping in one call.
+template <typename Sink>
+void escapeJson(const char *text, std::size_t size, Sink& sink)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char *begin = text, *end = text + size;
+    for (const char *c = text; c != end; ++c)
+    {
+        const unsigned char u = static_cast<unsigned char>(*c);
+        if (u >= 0x20 && u != '"' && u != '\\')
+            continue;
+        sink(begin, c - begin);
+        begin = c + 1;
+        switch (u)
+        {
+        case '"': sink("\\\"", 2); break;
+        case '\\': sink("\\\\", 2); break;
+        case '\n': sink("\\n", 2); break;
+        case '\t': sink("\\t", 2); break;
+        case '\r': sink("\\r", 2); break;
+        default:
+            const char escaped[] = { '\\', 'u', '0', '0', hex[u >> 4], hex[u & 0xf] };
+            sink(escaped, sizeof(escaped));
+        }
+    }
+    sink(begin, end - begin);
+}
+
+inline void writeJsonString(std::ostream& os, const std::string& text)
+{
+    auto write = [&](const char *s, std::size_t n) { os.write(s, n); };
+    os << '"';
+    escapeJson(text.data(), text.size(), write);
+    os << '"';
+}
+
+}
+
+}
+
+#endif // CXXSPEC_JSON_HPP
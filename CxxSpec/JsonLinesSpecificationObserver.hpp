@@ -0,0 +1,362 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_JSONLINESSPECIFICATIONOBSERVER_HPP
+#define CXXSPEC_JSONLINESSPECIFICATIONOBSERVER_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/Json.hpp>
+#include <CxxSpec/ThreadId.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+// Writes one JSON object per event to a file descriptor. Lines are built
+// in a fixed buffer that is written out when full, after a failure and on
+// destruction. The specification and the escaped context path are kept in
+// strings whose capacity is reused, so steady state reporting does not
+// allocate. Failures arrive after the contexts of their pass were left and
+// are reported with the path of the last leaf. Events are stamped with the
+// time they were raised, also when a multiplexer replays them later.
+class JsonLinesSpecificationObserver : public ISpecificationObserver
+{
+public:
+    static const std::size_t bufferSize = 64 * 1024;
+
+    explicit JsonLinesSpecificationObserver(int fd) : fd(fd), used(0), leaving(false) { }
+
+    ~JsonLinesSpecificationObserver()
+    {
+        flush();
+    }
+
+    virtual void testFailed(const AssertionFailed& af)
+    {
+        begin("failure", path.empty() ? leafPath : path, af.raised());
+        put(",\"file\":");
+        putString(af.file());
+        put(",\"line\":");
+        putNumber(af.line());
+        put(",\"expression\":");
+        putString(af.expression());
+        put(",\"expectation\":");
+        putString(af.expectation());
+        endLine();
+        flush();
+    }
+
+    virtual void testingSpecification(const std::string& spec)
+    {
+        testingSpecificationAt(spec, SourceLocation());
+    }
+
+    virtual void testingSpecificationAt(const std::string& spec, const SourceLocation& location)
+    {
+        specification.clear();
+        Sink sink = { specification };
+        Detail::escapeJson(spec.data(), spec.size(), sink);
+        path.clear();
+        pathLengths.clear();
+        leafPath.clear();
+        leaving = false;
+        begin("specification", path);
+        putLocation(location);
+        endLine();
+    }
+
+    virtual void enteredContext(const std::string& context)
+    {
+        enteredContextAt(context, SourceLocation());
+    }
+
+    virtual void enteredContextAt(const std::string& context, const SourceLocation& location)
+    {
+        if (leaving)
+        {
+            leafPath.clear();
+            leaving = false;
+        }
+        pathLengths.push_back(path.size());
+        if (!path.empty())
+            path += ',';
+        path += '"';
+        Sink sink = { path };
+        Detail::escapeJson(context.data(), context.size(), sink);
+        path += '"';
+        begin("enteredContext", path);
+        putLocation(location);
+        endLine();
+    }
+
+    virtual void leftContext()
+    {
+        begin("leftContext", path);
+        endLine();
+        if (!leaving)
+        {
+            leafPath = path;
+            leaving = true;
+        }
+        if (pathLengths.empty())
+            return;
+        path.resize(pathLengths.back());
+        pathLengths.pop_back();
+    }
+
+    virtual void allocationsMeasured(const AllocationStatistics& allocated)
+    {
+        begin("allocations", path.empty() ? leafPath : path);
+        put(",\"allocations\":");
+        putNumber(allocated.allocations);
+        put(",\"bytes\":");
+        putNumber(allocated.bytes);
+        endLine();
+    }
+
+    virtual void sectionTimed(const std::string& context, Timestamp start, Timestamp end, unsigned entries)
+    {
+        begin("sectionTimed", path);
+        put(",\"context\":");
+        putString(context);
+        putInterval(start, end);
+        put(",\"entries\":");
+        putNumber(entries);
+        endLine();
+    }
+
+    virtual void leafTimed(Timestamp start, Timestamp end)
+    {
+        begin("leafTimed", leafPath);
+        putInterval(start, end);
+        endLine();
+        leafPath.clear();
+        leaving = false;
+    }
+
+    virtual void specificationTimed(Timestamp start, Timestamp end, unsigned passes)
+    {
+        begin("specificationTimed", path);
+        putInterval(start, end);
+        put(",\"passes\":");
+        putNumber(passes);
+        endLine();
+    }
+
+    virtual void leafCountersMeasured(const PerformanceCounters& counters)
+    {
+        begin("leafCounters", path.empty() ? leafPath : path);
+        putCounters(counters);
+        endLine();
+    }
+
+    virtual void specificationCountersMeasured(const PerformanceCounters& counters)
+    {
+        begin("specificationCounters", path);
+        putCounters(counters);
+        endLine();
+    }
+
+    virtual void specificationCached()
+    {
+        begin("cached", path);
+        endLine();
+    }
+
+    virtual void specificationSkipped()
+    {
+        begin("skipped", path);
+        endLine();
+    }
+
+    void flush()
+    {
+        const char *data = buffer;
+        while (used)
+        {
+            const ssize_t written = ::write(fd, data, used);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                break;
+            data += written;
+            used -= std::size_t(written);
+        }
+        used = 0;
+    }
+
+private:
+    struct Sink
+    {
+        std::string& text;
+
+        void operator()(const char *s, std::size_t n) { text.append(s, n); }
+    };
+
+    int fd;
+    std::size_t used;
+    char buffer[bufferSize];
+    std::string specification, path, leafPath;
+    bool leaving;
+    std::vector<std::size_t> pathLengths;
+
+    void put(const char *s, std::size_t n)
+    {
+        while (n)
+        {
+            if (used == bufferSize)
+                flush();
+            const std::size_t chunk = n < bufferSize - used ? n : bufferSize - used;
+            std::memcpy(buffer + used, s, chunk);
+            used += chunk;
+            s += chunk;
+            n -= chunk;
+        }
+    }
+
+    void put(const char *s)
+    {
+        put(s, std::strlen(s));
+    }
+
+    void put(const std::string& s)
+    {
+        put(s.data(), s.size());
+    }
+
+    void putString(const char *text, std::size_t size)
+    {
+        auto sink = [this](const char *s, std::size_t n) { put(s, n); };
+        put("\"", 1);
+        Detail::escapeJson(text, size, sink);
+        put("\"", 1);
+    }
+
+    void putString(const std::string& text)
+    {
+        putString(text.data(), text.size());
+    }
+
+    template <typename Integer>
+    void putNumber(Integer value)
+    {
+        char digits[24];
+        char *first = digits + sizeof(digits);
+        const bool negative = value < 0;
+        std::uint64_t magnitude = negative ? 0 - std::uint64_t(value) : std::uint64_t(value);
+        do
+        {
+            *--first = char('0' + magnitude % 10);
+            magnitude /= 10;
+        }
+        while (magnitude);
+        if (negative)
+            *--first = '-';
+        put(first, digits + sizeof(digits) - first);
+    }
+
+    void putTimestamp(Timestamp timestamp)
+    {
+        putNumber(std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count());
+    }
+
+    void putInterval(Timestamp start, Timestamp end)
+    {
+        put(",\"start\":");
+        putTimestamp(start);
+        put(",\"end\":");
+        putTimestamp(end);
+    }
+
+    void putLocation(const SourceLocation& location)
+    {
+        if (!location.file)
+            return;
+        put(",\"file\":");
+        putString(location.file, std::strlen(location.file));
+        put(",\"line\":");
+        putNumber(location.line);
+    }
+
+    void putCounter(const char *name, std::uint64_t value)
+    {
+        put(",\"");
+        put(name);
+        put("\":");
+        putNumber(value);
+    }
+
+    void putCounters(const PerformanceCounters& counters)
+    {
+        if (counters.source == PerformanceCounters::Hardware)
+        {
+            put(",\"source\":\"perf\"");
+            putCounter("instructions", counters.instructions);
+            putCounter("cycles", counters.cycles);
+            putCounter("cacheMisses", counters.cacheMisses);
+            putCounter("branchMisses", counters.branchMisses);
+        }
+        else
+            put(",\"source\":\"rusage\"");
+        putCounter("cpuTime", counters.cpuTimeNanoseconds);
+        putCounter("pageFaults", counters.pageFaults);
+        putCounter("contextSwitches", counters.contextSwitches);
+        if (counters.source == PerformanceCounters::ResourceUsage)
+        {
+            putCounter("voluntaryContextSwitches", counters.voluntaryContextSwitches);
+            putCounter("involuntaryContextSwitches", counters.involuntaryContextSwitches);
+        }
+    }
+
+    void begin(const char *event, const std::string& eventPath, Timestamp raised = eventTime())
+    {
+        put("{\"timestamp\":");
+        putTimestamp(raised);
+        put(",\"thread\":");
+        putNumber(Detail::currentThreadId());
+        put(",\"event\":\"");
+        put(event);
+        put("\",\"spec\":\"");
+        put(specification);
+        put("\",\"path\":[");
+        put(eventPath);
+        put("]");
+    }
+
+    void endLine()
+    {
+        put("}\n", 2);
+    }
+};
+
+}
+
+#endif // CXXSPEC_JSONLINESSPECIFICATIONOBSERVER_HPP
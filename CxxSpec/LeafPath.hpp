@@ -0,0 +1,138 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_LEAFPATH_HPP
+#define CXXSPEC_LEAFPATH_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <string>
+#include <vector>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+// Follows the context events of a specification and remembers the path of
+// the leaf of the current pass. The contexts of a pass are all left when
+// its leaf ends, so the leaf is the path before the first leftContext.
+class LeafPath
+{
+public:
+    LeafPath() : leaving(false) { }
+
+    void reset()
+    {
+        path.clear();
+        leaf.clear();
+        leaving = false;
+    }
+
+    void entered(const std::string& context)
+    {
+        if (leaving)
+        {
+            leaf.clear();
+            leaving = false;
+        }
+        path.push_back(context);
+    }
+
+    void left()
+    {
+        if (!leaving)
+        {
+            leaf = path;
+            leaving = true;
+        }
+        if (!path.empty())
+            path.pop_back();
+    }
+
+    void passFinished()
+    {
+        leaf.clear();
+        leaving = false;
+    }
+
+    const std::vector<std::string>& contexts() const
+    {
+        return leaf;
+    }
+
+    std::string name(const std::string& spec) const
+    {
+        std::string name = spec;
+        for (const std::string& context : leaf)
+            name += " / " + context;
+        return name;
+    }
+
+private:
+    std::vector<std::string> path, leaf;
+    bool leaving;
+};
+
+// Follows the specification and the leaf path for observers which report
+// per leaf. leafFinished sees the leaf of each pass before it is cleared
+// for the next one.
+class LeafPathObserver : public ISpecificationObserver
+{
+public:
+    virtual void testingSpecification(const std::string& spec)
+    {
+        specification = spec;
+        leafPath.reset();
+    }
+
+    virtual void enteredContext(const std::string& context)
+    {
+        leafPath.entered(context);
+    }
+
+    virtual void leftContext()
+    {
+        leafPath.left();
+    }
+
+    virtual void leafTimed(Timestamp start, Timestamp end)
+    {
+        leafFinished(start, end);
+        leafPath.passFinished();
+    }
+
+protected:
+    std::string specification;
+    LeafPath leafPath;
+
+    virtual void leafFinished(Timestamp , Timestamp ) { }
+};
+
+}
+
+}
+
+#endif // CXXSPEC_LEAFPATH_HPP
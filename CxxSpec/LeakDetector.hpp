@@ -0,0 +1,77 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_LEAKDETECTOR_HPP
+#define CXXSPEC_LEAKDETECTOR_HPP
+#include <CxxSpec/AllocationCounter.hpp>
+#include <CxxSpec/AssertionFailed.hpp>
+#include <CxxSpec/SourceLocation.hpp>
+#include <sstream>
+#include <vector>
+
+namespace CxxSpec {
+
+class LeakDetector
+{
+public:
+    LeakDetector() : before(AllocationCounter::live()), serial(AllocationCounter::serial()) { }
+
+    bool leaked() const
+    {
+        return std::ptrdiff_t(leakedAllocations().allocations) > 0;
+    }
+
+    AssertionFailed failure(const std::string& spec, const SourceLocation& location = SourceLocation()) const
+    {
+        AllocationStatistics leaked = leakedAllocations();
+        std::ostringstream os;
+        os << "leaked " << leaked.allocations << " allocations (" << std::ptrdiff_t(leaked.bytes) << " bytes)";
+        for (const AllocationSample& sample : AllocationCounter::liveSamplesSince(serial))
+        {
+            os << "\nsampled allocation of " << sample.size << " bytes at:";
+            if (Detail::stackSymbolizer())
+                os << Detail::stackSymbolizer()(sample.frames, sample.depth);
+            else
+                for (int i = 0; i != sample.depth; ++i)
+                    os << "\n    " << sample.frames[i];
+        }
+        return AssertionFailed(location.file ? location.file : "", location.line, spec, os.str());
+    }
+
+private:
+    AllocationStatistics before;
+    std::size_t serial;
+
+    AllocationStatistics leakedAllocations() const
+    {
+        return AllocationCounter::live() - before;
+    }
+};
+
+}
+
+#endif // CXXSPEC_LEAKDETECTOR_HPP
@@ -0,0 +1,96 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_LINKEDSPECIFICATIONS_HPP
+#define CXXSPEC_LINKEDSPECIFICATIONS_HPP
+#include <CxxSpec/Specification.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// Bounds of the descriptor section, provided by the linker for the module
+// being linked. They are weak, so a module without descriptors sees null.
+extern "C"
+{
+extern const ::CxxSpec::SpecificationDescriptor __start_cxxspec_specifications[] __attribute__((weak, visibility("hidden")));
+extern const ::CxxSpec::SpecificationDescriptor __stop_cxxspec_specifications[] __attribute__((weak, visibility("hidden")));
+}
+
+namespace CxxSpec {
+
+// Descriptors of one module. Specifications of a named suite are reported
+// as "suite: description".
+struct SpecificationDescriptors
+{
+    const SpecificationDescriptor *first, *last;
+    const char *suite;
+};
+
+namespace Detail
+{
+
+// Hidden, so that a shared object never binds to the copy of the
+// executable and reads the executable's descriptors.
+__attribute__((visibility("hidden"))) inline SpecificationDescriptors linkedSpecifications()
+{
+    SpecificationDescriptors descriptors = { __start_cxxspec_specifications, __stop_cxxspec_specifications, nullptr };
+    if (!descriptors.first || !descriptors.last)
+        descriptors.first = descriptors.last = nullptr;
+    return descriptors;
+}
+
+// The linker keeps the order of the input files, but the compiler may emit
+// the descriptors of one file in any order, so they are run ordered by file
+// and line.
+inline std::vector<const SpecificationDescriptor *> orderedSpecifications(SpecificationDescriptors descriptors)
+{
+    std::vector<const SpecificationDescriptor *> ordered;
+    ordered.reserve(descriptors.last - descriptors.first);
+    for (const SpecificationDescriptor *descriptor = descriptors.first; descriptor != descriptors.last; ++descriptor)
+        ordered.push_back(descriptor);
+    std::stable_sort(ordered.begin(), ordered.end(), [](const SpecificationDescriptor *left, const SpecificationDescriptor *right)
+    {
+        const int files = std::strcmp(left->file, right->file);
+        return files < 0 || (files == 0 && left->line < right->line);
+    });
+    return ordered;
+}
+
+}
+
+}
+
+#ifdef CXXSPEC_USE_SECTION_REGISTRATION
+// Lets SpecificationLibrary find the descriptors of a shared object built
+// with section registration.
+extern "C" __attribute__((weak, visibility("default"))) ::CxxSpec::SpecificationDescriptors cxxspec_linkedSpecifications()
+{
+    return ::CxxSpec::Detail::linkedSpecifications();
+}
+#endif
+
+#endif // CXXSPEC_LINKEDSPECIFICATIONS_HPP
@@ -0,0 +1,478 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_MATCHERS_HPP
+#define CXXSPEC_MATCHERS_HPP
+#include <CxxSpec/Messages.hpp>
+#include <ostream>
+#include <string>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace CxxSpec {
+
+template <typename Derived>
+class Matcher
+{
+public:
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+    std::string description() const
+    {
+        std::ostringstream os;
+        derived().describeTo(os);
+        return os.str();
+    }
+};
+
+namespace Detail
+{
+
+// Characters of a string the matcher does not own, compared by content.
+// Matchers are built and used within one expectation, so referring to the
+// string, even to a temporary one, is safe and does not allocate.
+class StringReference
+{
+public:
+    StringReference(const char *text) : data(text), size(std::strlen(text)) { }
+    StringReference(const std::string& text) : data(text.data()), size(text.size()) { }
+
+    bool isPrefixOf(const std::string& text) const
+    {
+        return text.size() >= size && text.compare(0, size, data, size) == 0;
+    }
+
+    bool isSuffixOf(const std::string& text) const
+    {
+        return text.size() >= size && text.compare(text.size() - size, size, data, size) == 0;
+    }
+
+    bool isFoundIn(const std::string& text) const
+    {
+        return text.find(data, 0, size) != std::string::npos;
+    }
+
+    friend bool operator==(const StringReference& left, const StringReference& right)
+    {
+        return left.size == right.size && std::memcmp(left.data, right.data, left.size) == 0;
+    }
+
+    friend bool operator<(const StringReference& left, const StringReference& right)
+    {
+        const int order = std::memcmp(left.data, right.data, left.size < right.size ? left.size : right.size);
+        return order < 0 || (order == 0 && left.size < right.size);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const StringReference& text)
+    {
+        return os.write(text.data, text.size);
+    }
+
+private:
+    const char *data;
+    std::size_t size;
+};
+
+template <typename Element>
+inline bool isFoundIn(const std::string& text, const Element& element)
+{
+    return text.find(element) != std::string::npos;
+}
+
+inline bool isFoundIn(const std::string& text, const StringReference& element)
+{
+    return element.isFoundIn(text);
+}
+
+template <typename T>
+struct StoredDecayed
+{
+    typedef T type;
+};
+
+template <>
+struct StoredDecayed<const char *>
+{
+    typedef StringReference type;
+};
+
+template <>
+struct StoredDecayed<char *>
+{
+    typedef StringReference type;
+};
+
+// How a matcher keeps an expected value. C strings are referred to and
+// compared by content, everything else is copied.
+template <typename T>
+struct Stored
+{
+    typedef typename StoredDecayed<typename std::decay<const T>::type>::type type;
+};
+
+template <typename T>
+inline void describeValue(std::ostream& os, const T& value, std::true_type)
+{
+    os << std::boolalpha << value;
+}
+
+template <typename T>
+inline void describeValue(std::ostream& os, const T&, std::false_type)
+{
+    os << "an unprintable value";
+}
+
+template <typename T>
+inline void describeValue(std::ostream& os, const T& value)
+{
+    describeValue(os, value, std::integral_constant<bool, IsPrintable<T>::value>());
+}
+
+}
+
+template <typename Expected>
+class EqualTo : public Matcher<EqualTo<Expected>>
+{
+public:
+    explicit EqualTo(const Expected& expected) : expected(expected) { }
+
+    template <typename Actual>
+    bool matches(const Actual& actual) const { return actual == expected; }
+
+    void describeTo(std::ostream& os) const
+    {
+        os << "equal to ";
+        Detail::describeValue(os, expected);
+    }
+
+private:
+    Expected expected;
+};
+
+template <typename Expected>
+class LessThan : public Matcher<LessThan<Expected>>
+{
+public:
+    explicit LessThan(const Expected& expected) : expected(expected) { }
+
+    template <typename Actual>
+    bool matches(const Actual& actual) const { return actual < expected; }
+
+    void describeTo(std::ostream& os) const
+    {
+        os << "less than ";
+        Detail::describeValue(os, expected);
+    }
+
+private:
+    Expected expected;
+};
+
+template <typename Expected>
+class GreaterThan : public Matcher<GreaterThan<Expected>>
+{
+public:
+    explicit GreaterThan(const Expected& expected) : expected(expected) { }
+
+    template <typename Actual>
+    bool matches(const Actual& actual) const { return expected < actual; }
+
+    void describeTo(std::ostream& os) const
+    {
+        os << "greater than ";
+        Detail::describeValue(os, expected);
+    }
+
+private:
+    Expected expected;
+};
+
+template <typename Bound>
+class InRange : public Matcher<InRange<Bound>>
+{
+public:
+    InRange(const Bound& low, const Bound& high) : low(low), high(high) { }
+
+    template <typename Actual>
+    bool matches(const Actual& actual) const { return !(actual < low) && !(high < actual); }
+
+    void describeTo(std::ostream& os) const
+    {
+        os << "in range [";
+        Detail::describeValue(os, low);
+        os << ", ";
+        Detail::describeValue(os, high);
+        os << "]";
+    }
+
+private:
+    Bound low, high;
+};
+
+template <typename Element>
+class Contains : public Matcher<Contains<Element>>
+{
+public:
+    explicit Contains(const Element& element) : element(element) { }
+
+    bool matches(const std::string& actual) const { return Detail::isFoundIn(actual, element); }
+
+    template <typename Range>
+    bool matches(const Range& range) const
+    {
+        for (auto&& e : range)
+            if (e == element)
+                return true;
+        return false;
+    }
+
+    void describeTo(std::ostream& os) const
+    {
+        os << "containing ";
+        Detail::describeValue(os, element);
+    }
+
+private:
+    Element element;
+};
+
+class StartsWith : public Matcher<StartsWith>
+{
+public:
+    explicit StartsWith(Detail::StringReference prefix) : prefix(prefix) { }
+
+    bool matches(const std::string& actual) const { return prefix.isPrefixOf(actual); }
+
+    void describeTo(std::ostream& os) const { os << "starting with " << prefix; }
+
+private:
+    Detail::StringReference prefix;
+};
+
+class EndsWith : public Matcher<EndsWith>
+{
+public:
+    explicit EndsWith(Detail::StringReference suffix) : suffix(suffix) { }
+
+    bool matches(const std::string& actual) const { return suffix.isSuffixOf(actual); }
+
+    void describeTo(std::ostream& os) const { os << "ending with " << suffix; }
+
+private:
+    Detail::StringReference suffix;
+};
+
+class IsEmpty : public Matcher<IsEmpty>
+{
+public:
+    template <typename Container>
+    bool matches(const Container& container) const { return container.empty(); }
+
+    void describeTo(std::ostream& os) const { os << "empty"; }
+};
+
+class HasSize : public Matcher<HasSize>
+{
+public:
+    explicit HasSize(std::size_t size) : size(size) { }
+
+    template <typename Container>
+    bool matches(const Container& container) const { return container.size() == size; }
+
+    void describeTo(std::ostream& os) const { os << "of size " << size; }
+
+private:
+    std::size_t size;
+};
+
+template <typename Inner>
+class IsNot : public Matcher<IsNot<Inner>>
+{
+public:
+    explicit IsNot(const Inner& inner) : inner(inner) { }
+
+    template <typename Actual>
+    bool matches(const Actual& actual) const { return !inner.matches(actual); }
+
+    void describeTo(std::ostream& os) const
+    {
+        os << "not ";
+        inner.describeTo(os);
+    }
+
+private:
+    Inner inner;
+};
+
+template <typename Left, typename Right>
+class AllOf : public Matcher<AllOf<Left, Right>>
+{
+public:
+    AllOf(const Left& left, const Right& right) : left(left), right(right) { }
+
+    template <typename Actual>
+    bool matches(const Actual& actual) const { return left.matches(actual) && right.matches(actual); }
+
+    void describeTo(std::ostream& os) const
+    {
+        os << "(";
+        left.describeTo(os);
+        os << " and ";
+        right.describeTo(os);
+        os << ")";
+    }
+
+private:
+    Left left;
+    Right right;
+};
+
+template <typename Left, typename Right>
+class AnyOf : public Matcher<AnyOf<Left, Right>>
+{
+public:
+    AnyOf(const Left& left, const Right& right) : left(left), right(right) { }
+
+    template <typename Actual>
+    bool matches(const Actual& actual) const { return left.matches(actual) || right.matches(actual); }
+
+    void describeTo(std::ostream& os) const
+    {
+        os << "(";
+        left.describeTo(os);
+        os << " or ";
+        right.describeTo(os);
+        os << ")";
+    }
+
+private:
+    Left left;
+    Right right;
+};
+
+namespace Detail
+{
+
+template <template <typename, typename> class Combination, typename... Matchers>
+struct Combine;
+
+template <template <typename, typename> class Combination, typename Last>
+struct Combine<Combination, Last>
+{
+    typedef Last type;
+
+    static const Last& make(const Last& last) { return last; }
+};
+
+template <template <typename, typename> class Combination, typename First, typename... Rest>
+struct Combine<Combination, First, Rest...>
+{
+    typedef Combination<First, typename Combine<Combination, Rest...>::type> type;
+
+    static type make(const First& first, const Rest&... rest)
+    {
+        return type(first, Combine<Combination, Rest...>::make(rest...));
+    }
+};
+
+}
+
+template <typename Expected>
+inline EqualTo<typename Detail::Stored<Expected>::type> equalTo(const Expected& expected)
+{
+    return EqualTo<typename Detail::Stored<Expected>::type>(expected);
+}
+
+template <typename Expected>
+inline LessThan<typename Detail::Stored<Expected>::type> lessThan(const Expected& expected)
+{
+    return LessThan<typename Detail::Stored<Expected>::type>(expected);
+}
+
+template <typename Expected>
+inline GreaterThan<typename Detail::Stored<Expected>::type> greaterThan(const Expected& expected)
+{
+    return GreaterThan<typename Detail::Stored<Expected>::type>(expected);
+}
+
+template <typename Bound>
+inline InRange<typename Detail::Stored<Bound>::type> inRange(const Bound& low, const Bound& high)
+{
+    return InRange<typename Detail::Stored<Bound>::type>(low, high);
+}
+
+template <typename Element>
+inline Contains<typename Detail::Stored<Element>::type> contains(const Element& element)
+{
+    return Contains<typename Detail::Stored<Element>::type>(element);
+}
+
+inline StartsWith startsWith(Detail::StringReference prefix) { return StartsWith(prefix); }
+
+inline EndsWith endsWith(Detail::StringReference suffix) { return EndsWith(suffix); }
+
+inline IsEmpty isEmpty() { return IsEmpty(); }
+
+inline HasSize hasSize(std::size_t size) { return HasSize(size); }
+
+template <typename Inner>
+inline IsNot<Inner> isNot(const Matcher<Inner>& inner) { return IsNot<Inner>(inner.derived()); }
+
+template <typename... Matchers>
+inline typename Detail::Combine<AllOf, Matchers...>::type allOf(const Matchers&... matchers)
+{
+    return Detail::Combine<AllOf, Matchers...>::make(matchers...);
+}
+
+template <typename... Matchers>
+inline typename Detail::Combine<AnyOf, Matchers...>::type anyOf(const Matchers&... matchers)
+{
+    return Detail::Combine<AnyOf, Matchers...>::make(matchers...);
+}
+
+template <typename Left, typename Right>
+inline AllOf<Left, Right> operator&&(const Matcher<Left>& left, const Matcher<Right>& right)
+{
+    return AllOf<Left, Right>(left.derived(), right.derived());
+}
+
+template <typename Left, typename Right>
+inline AnyOf<Left, Right> operator||(const Matcher<Left>& left, const Matcher<Right>& right)
+{
+    return AnyOf<Left, Right>(left.derived(), right.derived());
+}
+
+template <typename Inner>
+inline IsNot<Inner> operator!(const Matcher<Inner>& inner)
+{
+    return IsNot<Inner>(inner.derived());
+}
+
+}
+
+#endif // CXXSPEC_MATCHERS_HPP
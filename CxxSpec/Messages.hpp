@@ -29,6 +29,8 @@
 #define CXXSPEC_MESSAGES_HPP
 #include <iomanip>
 #include <sstream>
+#include <utility>
+#include <CxxSpec/StringDiff.hpp>
 
 namespace CxxSpec {
 
@@ -43,18 +45,14 @@ inline std::string toString(const Expression& expr)
 namespace Detail
 {
 
-struct UniqType
-{
-    char c[17943];
-};
-
-template <typename T>
-UniqType operator<<(std::ostream&, const T& );
-
 template <typename T>
 struct IsPrintable {
-    static const bool value =
-        sizeof(*static_cast<std::ostream *>(nullptr) << *static_cast<const T *>(nullptr)) != sizeof(UniqType);
+    template <typename U>
+    static char test(int, decltype(void(std::declval<std::ostream&>() << std::declval<const U&>())) * = nullptr);
+    template <typename U>
+    static long test(...);
+
+    static const bool value = sizeof(test<T>(0)) == sizeof(char);
 };
 
 template <>
@@ -64,22 +62,75 @@ struct IsPrintable<void> {
 
 };
 
-template <typename Expression, bool ExpressionPrintable = Detail::IsPrintable<Expression>::value>
+template <typename Actual, typename Expected = Actual,
+    bool Printable = Detail::IsPrintable<Actual>::value && Detail::IsPrintable<Expected>::value>
 struct Messages
 {
-    static std::string equalityFailed(const Expression&, const Expression&)
+    static std::string equalityFailed(const Actual&, const Expected&)
     {
         return "failed equality check";
     }
+
+    static std::string inequalityFailed(const Actual&, const Expected&)
+    {
+        return "failed inequality check";
+    }
+
+    static std::string comparisonFailed(const std::string&, const Actual&, const Expected&)
+    {
+        return "failed comparison check";
+    }
+
+    static std::string matchFailed(const std::string& description, const Actual&)
+    {
+        return "expected to be " + description;
+    }
 };
 
-template <typename Expression>
-struct Messages<Expression, true>
+namespace Detail
+{
+
+template <typename Actual, typename Expected>
+struct PrintableMessages
 {
-    static std::string equalityFailed(const Expression& actual, const Expression& expected)
+    static std::string equalityFailed(const Actual& actual, const Expected& expected)
     {
         return "expected to equal " + toString(expected) + " but equals " + toString(actual);
     }
+
+    static std::string inequalityFailed(const Actual&, const Expected& expected)
+    {
+        return "expected not to equal " + toString(expected);
+    }
+
+    static std::string comparisonFailed(const std::string& relation, const Actual& actual, const Expected& expected)
+    {
+        return "expected to be " + relation + " " + toString(expected) + " but equals " + toString(actual);
+    }
+
+    static std::string matchFailed(const std::string& description, const Actual& actual)
+    {
+        return "expected to be " + description + " but equals " + toString(actual);
+    }
+};
+
+}
+
+template <typename Actual, typename Expected>
+struct Messages<Actual, Expected, true> : Detail::PrintableMessages<Actual, Expected>
+{
+};
+
+template <typename Expected>
+struct Messages<std::string, Expected, true> : Detail::PrintableMessages<std::string, Expected>
+{
+    static std::string equalityFailed(const std::string& actual, const Expected& expected)
+    {
+        const std::string expectedString = toString(expected);
+        if (!StringDiff::isWorthDiffing(expectedString, actual))
+            return Detail::PrintableMessages<std::string, Expected>::equalityFailed(actual, expected);
+        return "expected to equal the expected string but differs:\n" + StringDiff(expectedString, actual).str();
+    }
 };
 
 }
@@ -0,0 +1,360 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_MULTIPLEXINGSPECIFICATIONOBSERVER_HPP
+#define CXXSPEC_MULTIPLEXINGSPECIFICATIONOBSERVER_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+// Events of one specification, recorded on the thread running it.
+class ObserverEventBuffer
+{
+public:
+    bool empty() const { return events.empty(); }
+
+    void testFailed(const AssertionFailed& af)
+    {
+        events.push_back(Event(Event::Failed, std::string(), failures.size()));
+        failures.push_back(af);
+    }
+
+    void testingSpecification(const std::string& spec, const SourceLocation& location)
+    {
+        Event event(Event::TestingSpecification, spec);
+        event.location = location;
+        events.push_back(event);
+    }
+
+    void enteredContext(const std::string& context, const SourceLocation& location)
+    {
+        Event event(Event::EnteredContext, context);
+        event.location = location;
+        events.push_back(event);
+    }
+
+    void leftContext()
+    {
+        events.push_back(Event(Event::LeftContext, std::string()));
+    }
+
+    void allocationsMeasured(const AllocationStatistics& allocated)
+    {
+        Event event(Event::AllocationsMeasured, std::string());
+        event.allocations = allocated;
+        events.push_back(event);
+    }
+
+    void finishedSpecification()
+    {
+        events.push_back(Event(Event::FinishedSpecification, std::string()));
+    }
+
+    void sectionTimed(const std::string& context, Timestamp start, Timestamp end, unsigned entries)
+    {
+        events.push_back(Event(Event::SectionTimed, context, start, end, entries));
+    }
+
+    void leafTimed(Timestamp start, Timestamp end)
+    {
+        events.push_back(Event(Event::LeafTimed, std::string(), start, end));
+    }
+
+    void specificationTimed(Timestamp start, Timestamp end, unsigned passes)
+    {
+        events.push_back(Event(Event::SpecificationTimed, std::string(), start, end, passes));
+    }
+
+    void leafCountersMeasured(const PerformanceCounters& counters)
+    {
+        Event event(Event::LeafCountersMeasured, std::string());
+        event.counters = counters;
+        events.push_back(event);
+    }
+
+    void specificationCountersMeasured(const PerformanceCounters& counters)
+    {
+        Event event(Event::SpecificationCountersMeasured, std::string());
+        event.counters = counters;
+        events.push_back(event);
+    }
+
+    void specificationCached()
+    {
+        events.push_back(Event(Event::SpecificationCached, std::string()));
+    }
+
+    void specificationSkipped()
+    {
+        events.push_back(Event(Event::SpecificationSkipped, std::string()));
+    }
+
+    void specificationNarrowedToLeaf()
+    {
+        events.push_back(Event(Event::SpecificationNarrowedToLeaf, std::string()));
+    }
+
+    // Observers asking for eventTime() get the time each event was raised.
+    void replay(ISpecificationObserver& observer) const
+    {
+        const Timestamp *const outer = replayedEventTime();
+        for (const Event& event : events)
+        {
+            replayedEventTime() = &event.raised;
+            switch (event.kind)
+            {
+            case Event::Failed: observer.testFailed(failures[event.failure]); break;
+            case Event::TestingSpecification: observer.testingSpecificationAt(event.text, event.location); break;
+            case Event::EnteredContext: observer.enteredContextAt(event.text, event.location); break;
+            case Event::LeftContext: observer.leftContext(); break;
+            case Event::AllocationsMeasured: observer.allocationsMeasured(event.allocations); break;
+            case Event::FinishedSpecification: observer.finishedSpecification(); break;
+            case Event::SectionTimed: observer.sectionTimed(event.text, event.start, event.end, event.count); break;
+            case Event::LeafTimed: observer.leafTimed(event.start, event.end); break;
+            case Event::SpecificationTimed: observer.specificationTimed(event.start, event.end, event.count); break;
+            case Event::LeafCountersMeasured: observer.leafCountersMeasured(event.counters); break;
+            case Event::SpecificationCountersMeasured: observer.specificationCountersMeasured(event.counters); break;
+            case Event::SpecificationCached: observer.specificationCached(); break;
+            case Event::SpecificationSkipped: observer.specificationSkipped(); break;
+            case Event::SpecificationNarrowedToLeaf: observer.specificationNarrowedToLeaf(); break;
+            }
+        }
+        replayedEventTime() = outer;
+    }
+
+    void clear()
+    {
+        events.clear();
+        failures.clear();
+    }
+
+private:
+    struct Event
+    {
+        enum Kind
+        {
+            Failed, TestingSpecification, EnteredContext, LeftContext, AllocationsMeasured, FinishedSpecification,
+            SectionTimed, LeafTimed, SpecificationTimed, LeafCountersMeasured, SpecificationCountersMeasured,
+            SpecificationCached, SpecificationSkipped, SpecificationNarrowedToLeaf
+        };
+
+        Kind kind;
+        std::string text;
+        std::size_t failure;
+        AllocationStatistics allocations;
+        Timestamp start, end;
+        unsigned count;
+        PerformanceCounters counters;
+        SourceLocation location;
+        Timestamp raised;
+
+        Event(Kind kind, const std::string& text, std::size_t failure = 0)
+            : kind(kind), text(text), failure(failure), allocations(), count(0), raised(eventTime()) { }
+
+        Event(Kind kind, const std::string& text, Timestamp start, Timestamp end, unsigned count = 0)
+            : kind(kind), text(text), failure(0), allocations(), start(start), end(end), count(count), raised(eventTime()) { }
+    };
+
+    std::vector<Event> events;
+    std::vector<AssertionFailed> failures;
+};
+
+inline std::uint64_t nextMultiplexingObserverId()
+{
+    static std::atomic<std::uint64_t> id(0);
+    return ++id;
+}
+
+}
+
+// Forwards the events to any number of observers. Each thread records the
+// events of the specification it runs in its own buffer, and the buffer is
+// replayed to every observer when the specification finishes. Replays are
+// serialized, so the observers see whole specifications in completion
+// order and are never called concurrently.
+class MultiplexingSpecificationObserver : public ISpecificationObserver
+{
+public:
+    MultiplexingSpecificationObserver() : id(Detail::nextMultiplexingObserverId()) { }
+
+    ~MultiplexingSpecificationObserver()
+    {
+        for (auto& buffer : buffers)
+            publish(*buffer.second);
+    }
+
+    void add(std::shared_ptr<ISpecificationObserver> observer)
+    {
+        std::lock_guard<std::mutex> lock(publishing);
+        observers.push_back(observer);
+    }
+
+    virtual void testFailed(const AssertionFailed& af)
+    {
+        threadBuffer().testFailed(af);
+    }
+
+    virtual void testingSpecification(const std::string& spec)
+    {
+        testingSpecificationAt(spec, SourceLocation());
+    }
+
+    virtual void testingSpecificationAt(const std::string& spec, const SourceLocation& location)
+    {
+        Detail::ObserverEventBuffer& buffer = threadBuffer();
+        publish(buffer);
+        buffer.testingSpecification(spec, location);
+    }
+
+    virtual void enteredContext(const std::string& context)
+    {
+        enteredContextAt(context, SourceLocation());
+    }
+
+    virtual void enteredContextAt(const std::string& context, const SourceLocation& location)
+    {
+        threadBuffer().enteredContext(context, location);
+    }
+
+    virtual void leftContext()
+    {
+        threadBuffer().leftContext();
+    }
+
+    virtual void allocationsMeasured(const AllocationStatistics& allocated)
+    {
+        threadBuffer().allocationsMeasured(allocated);
+    }
+
+    virtual void finishedSpecification()
+    {
+        Detail::ObserverEventBuffer& buffer = threadBuffer();
+        buffer.finishedSpecification();
+        publish(buffer);
+    }
+
+    virtual void finishedRun()
+    {
+        publish(threadBuffer());
+        std::lock_guard<std::mutex> lock(publishing);
+        for (const auto& observer : observers)
+            observer->finishedRun();
+    }
+
+    virtual void sectionTimed(const std::string& context, Timestamp start, Timestamp end, unsigned entries)
+    {
+        threadBuffer().sectionTimed(context, start, end, entries);
+    }
+
+    virtual void leafTimed(Timestamp start, Timestamp end)
+    {
+        threadBuffer().leafTimed(start, end);
+    }
+
+    virtual void specificationTimed(Timestamp start, Timestamp end, unsigned passes)
+    {
+        threadBuffer().specificationTimed(start, end, passes);
+    }
+
+    virtual void leafCountersMeasured(const PerformanceCounters& counters)
+    {
+        threadBuffer().leafCountersMeasured(counters);
+    }
+
+    virtual void specificationCountersMeasured(const PerformanceCounters& counters)
+    {
+        threadBuffer().specificationCountersMeasured(counters);
+    }
+
+    virtual void specificationCached()
+    {
+        threadBuffer().specificationCached();
+    }
+
+    virtual void specificationSkipped()
+    {
+        threadBuffer().specificationSkipped();
+    }
+
+    virtual void specificationNarrowedToLeaf()
+    {
+        threadBuffer().specificationNarrowedToLeaf();
+    }
+
+private:
+    struct CachedBuffer
+    {
+        std::uint64_t owner;
+        Detail::ObserverEventBuffer *buffer;
+    };
+
+    const std::uint64_t id;
+    std::mutex publishing, registering;
+    std::vector<std::shared_ptr<ISpecificationObserver>> observers;
+    std::map<std::thread::id, std::unique_ptr<Detail::ObserverEventBuffer>> buffers;
+
+    Detail::ObserverEventBuffer& threadBuffer()
+    {
+        static thread_local CachedBuffer cached = { 0, nullptr };
+        if (cached.owner == id)
+            return *cached.buffer;
+        std::lock_guard<std::mutex> lock(registering);
+        std::unique_ptr<Detail::ObserverEventBuffer>& buffer = buffers[std::this_thread::get_id()];
+        if (!buffer)
+            buffer.reset(new Detail::ObserverEventBuffer);
+        cached.owner = id;
+        cached.buffer = buffer.get();
+        return *buffer;
+    }
+
+    void publish(Detail::ObserverEventBuffer& buffer)
+    {
+        if (buffer.empty())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(publishing);
+            for (const auto& observer : observers)
+                buffer.replay(*observer);
+        }
+        buffer.clear();
+    }
+};
+
+}
+
+#endif // CXXSPEC_MULTIPLEXINGSPECIFICATIONOBSERVER_HPP
@@ -0,0 +1,171 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_PERFORMANCECOUNTERGROUP_HPP
+#define CXXSPEC_PERFORMANCECOUNTERGROUP_HPP
+#include <CxxSpec/PerformanceCounters.hpp>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+// Counts events of the calling thread. The hardware and software counters
+// are opened as one perf event group, so a reading is a single read(2).
+// When perf events cannot be opened, for example because of
+// perf_event_paranoid or a seccomp profile, readings come from
+// getrusage(RUSAGE_THREAD) instead.
+class PerformanceCounterGroup : public IPerformanceCounterGroup
+{
+public:
+    PerformanceCounterGroup(const PerformanceCounterGroup& ) = delete;
+    PerformanceCounterGroup& operator=(const PerformanceCounterGroup& ) = delete;
+
+    explicit PerformanceCounterGroup(bool useHardwareCounters = true) : leader(-1)
+    {
+        for (int& index : indices)
+            index = -1;
+        if (!useHardwareCounters)
+            return;
+        leader = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (leader < 0)
+            return;
+        descriptors.push_back(leader);
+        indices[Cycles] = 0;
+        addCounter(Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        addCounter(CacheMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        addCounter(BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        addCounter(TaskClock, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+        addCounter(PageFaults, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+        addCounter(ContextSwitches, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+        ::ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~PerformanceCounterGroup()
+    {
+        for (int fd : descriptors)
+            ::close(fd);
+    }
+
+    PerformanceCounters::Source source() const
+    {
+        return leader >= 0 ? PerformanceCounters::Hardware : PerformanceCounters::ResourceUsage;
+    }
+
+    virtual PerformanceCounters read() const
+    {
+        PerformanceCounters counters;
+        if (leader >= 0)
+            readGroup(counters);
+        else
+            readResourceUsage(counters);
+        return counters;
+    }
+
+private:
+    enum Counter { Cycles, Instructions, CacheMisses, BranchMisses, TaskClock, PageFaults, ContextSwitches, CounterCount };
+
+    int leader;
+    int indices[CounterCount];
+    std::vector<int> descriptors;
+
+    static int openCounter(std::uint32_t type, std::uint64_t config, int group)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = group < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return int(::syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    void addCounter(Counter counter, std::uint32_t type, std::uint64_t config)
+    {
+        const int fd = openCounter(type, config, leader);
+        if (fd < 0)
+            return;
+        indices[counter] = int(descriptors.size());
+        descriptors.push_back(fd);
+    }
+
+    std::uint64_t value(const std::uint64_t *values, Counter counter) const
+    {
+        return indices[counter] < 0 ? 0 : values[indices[counter]];
+    }
+
+    void readGroup(PerformanceCounters& counters) const
+    {
+        std::uint64_t buffer[1 + CounterCount] = { };
+        if (::read(leader, buffer, sizeof(buffer)) < ssize_t(sizeof(std::uint64_t)))
+            return;
+        const std::uint64_t *values = buffer + 1;
+        counters.source = PerformanceCounters::Hardware;
+        counters.cycles = value(values, Cycles);
+        counters.instructions = value(values, Instructions);
+        counters.cacheMisses = value(values, CacheMisses);
+        counters.branchMisses = value(values, BranchMisses);
+        counters.cpuTimeNanoseconds = value(values, TaskClock);
+        counters.pageFaults = value(values, PageFaults);
+        counters.contextSwitches = value(values, ContextSwitches);
+    }
+
+    static void readResourceUsage(PerformanceCounters& counters)
+    {
+        struct rusage usage;
+        if (::getrusage(RUSAGE_THREAD, &usage) != 0)
+            return;
+        counters.source = PerformanceCounters::ResourceUsage;
+        counters.cpuTimeNanoseconds =
+            (std::uint64_t(usage.ru_utime.tv_sec) + std::uint64_t(usage.ru_stime.tv_sec)) * 1000000000u +
+            (std::uint64_t(usage.ru_utime.tv_usec) + std::uint64_t(usage.ru_stime.tv_usec)) * 1000u;
+        counters.pageFaults = std::uint64_t(usage.ru_minflt) + std::uint64_t(usage.ru_majflt);
+        counters.voluntaryContextSwitches = std::uint64_t(usage.ru_nvcsw);
+        counters.involuntaryContextSwitches = std::uint64_t(usage.ru_nivcsw);
+        counters.contextSwitches = counters.voluntaryContextSwitches + counters.involuntaryContextSwitches;
+    }
+};
+
+// Opens the counters for SpecificationRegistry::measureCounters.
+inline std::unique_ptr<IPerformanceCounterGroup> openPerformanceCounters()
+{
+    return std::unique_ptr<IPerformanceCounterGroup>(new PerformanceCounterGroup);
+}
+
+}
+
+#endif // CXXSPEC_PERFORMANCECOUNTERGROUP_HPP
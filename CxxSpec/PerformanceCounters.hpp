@@ -0,0 +1,95 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_PERFORMANCECOUNTERS_HPP
+#define CXXSPEC_PERFORMANCECOUNTERS_HPP
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace CxxSpec {
+
+struct PerformanceCounters
+{
+    enum Source { Unavailable, Hardware, ResourceUsage };
+
+    Source source;
+    std::uint64_t instructions, cycles, cacheMisses, branchMisses;
+    std::uint64_t cpuTimeNanoseconds, pageFaults, contextSwitches;
+    std::uint64_t voluntaryContextSwitches, involuntaryContextSwitches;
+
+    PerformanceCounters()
+        : source(Unavailable), instructions(0), cycles(0), cacheMisses(0), branchMisses(0),
+        cpuTimeNanoseconds(0), pageFaults(0), contextSwitches(0), voluntaryContextSwitches(0), involuntaryContextSwitches(0) { }
+
+    PerformanceCounters& operator+=(const PerformanceCounters& other)
+    {
+        source = other.source;
+        instructions += other.instructions;
+        cycles += other.cycles;
+        cacheMisses += other.cacheMisses;
+        branchMisses += other.branchMisses;
+        cpuTimeNanoseconds += other.cpuTimeNanoseconds;
+        pageFaults += other.pageFaults;
+        contextSwitches += other.contextSwitches;
+        voluntaryContextSwitches += other.voluntaryContextSwitches;
+        involuntaryContextSwitches += other.involuntaryContextSwitches;
+        return *this;
+    }
+
+    friend PerformanceCounters operator-(const PerformanceCounters& left, const PerformanceCounters& right)
+    {
+        PerformanceCounters difference;
+        difference.source = left.source;
+        difference.instructions = left.instructions - right.instructions;
+        difference.cycles = left.cycles - right.cycles;
+        difference.cacheMisses = left.cacheMisses - right.cacheMisses;
+        difference.branchMisses = left.branchMisses - right.branchMisses;
+        difference.cpuTimeNanoseconds = left.cpuTimeNanoseconds - right.cpuTimeNanoseconds;
+        difference.pageFaults = left.pageFaults - right.pageFaults;
+        difference.contextSwitches = left.contextSwitches - right.contextSwitches;
+        difference.voluntaryContextSwitches = left.voluntaryContextSwitches - right.voluntaryContextSwitches;
+        difference.involuntaryContextSwitches = left.involuntaryContextSwitches - right.involuntaryContextSwitches;
+        return difference;
+    }
+};
+
+// Reads the counters of the thread which opened it, e.g. a
+// PerformanceCounterGroup.
+class IPerformanceCounterGroup
+{
+public:
+    virtual ~IPerformanceCounterGroup() { }
+    virtual PerformanceCounters read() const = 0;
+};
+
+// Opens a counter group for the calling thread.
+typedef std::function<std::unique_ptr<IPerformanceCounterGroup>()> PerformanceCounterFactory;
+
+}
+
+#endif // CXXSPEC_PERFORMANCECOUNTERS_HPP
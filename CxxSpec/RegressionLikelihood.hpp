@@ -0,0 +1,109 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_REGRESSIONLIKELIHOOD_HPP
+#define CXXSPEC_REGRESSIONLIKELIHOOD_HPP
+#include <CxxSpec/ChangedFiles.hpp>
+#include <CxxSpec/DurationHistory.hpp>
+#include <CxxSpec/SourceLocation.hpp>
+#include <algorithm>
+#include <memory>
+#include <string>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+const double regressionPrior = 0.05;
+const double failureWeight = 1.0;
+const double flakinessWeight = 0.5;
+const double changeWeight = 1.0;
+const double minimumNanoseconds = 1e6;
+
+}
+
+// Scores specifications by how likely they are to find a regression per
+// second of their expected duration, so a run which cannot afford all of
+// them starts those most worth running. The likelihood is the sum of:
+//
+// - the failures of the recent runs, each weighing half as much as the one
+//   after it;
+// - the flakiness, as the share of the recent runs whose outcome differs
+//   from the run before;
+// - whether the specification is new or defined in a changed file;
+// - a small prior, so that every specification is worth something.
+//
+// Durations come from the same history, and are at least a millisecond,
+// so a specification which was never timed is not taken as free.
+class RegressionLikelihood
+{
+public:
+    RegressionLikelihood(std::shared_ptr<const DurationHistory> history, std::shared_ptr<const ChangedFileSelection> changed)
+        : history(history), changed(changed) { }
+
+    double operator()(const std::string& description, const SourceLocation& location) const
+    {
+        double likelihood = Detail::regressionPrior;
+        auto found = history->entries().find(description);
+        if (found == history->entries().end())
+            likelihood += Detail::changeWeight;
+        else
+            likelihood += Detail::failureWeight * recentFailures(found->second) + Detail::flakinessWeight * flakiness(found->second);
+        if (changed && location.file && changed->selects(location.file))
+            likelihood += Detail::changeWeight;
+        const double seconds = std::max(double(history->estimate(description)), Detail::minimumNanoseconds) / 1e9;
+        return likelihood / seconds;
+    }
+
+private:
+    std::shared_ptr<const DurationHistory> history;
+    std::shared_ptr<const ChangedFileSelection> changed;
+
+    static double recentFailures(const DurationHistory::Durations& durations)
+    {
+        double failures = 0, weight = 1;
+        for (unsigned run = 0; run != durations.runs; ++run, weight /= 2)
+            if (durations.failures & (1u << run))
+                failures += weight;
+        return failures;
+    }
+
+    static double flakiness(const DurationHistory::Durations& durations)
+    {
+        if (durations.runs < 2)
+            return 0;
+        unsigned flips = 0;
+        for (unsigned run = 1; run != durations.runs; ++run)
+            flips += ((durations.failures >> run) & 1u) != ((durations.failures >> (run - 1)) & 1u);
+        return double(flips) / (durations.runs - 1);
+    }
+};
+
+}
+
+#endif // CXXSPEC_REGRESSIONLIKELIHOOD_HPP
@@ -0,0 +1,270 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_RESULTCACHE_HPP
+#define CXXSPEC_RESULTCACHE_HPP
+#include <CxxSpec/IResultCache.hpp>
+#include <CxxSpec/Specification.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+static const std::uint64_t fnvOffsetBasis = 14695981039346656037ull;
+
+inline std::uint64_t fnv1a(const void *data, std::size_t size, std::uint64_t hash = fnvOffsetBasis)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i != size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+inline std::uint64_t fnv1a(const std::string& text, std::uint64_t hash = fnvOffsetBasis)
+{
+    return fnv1a(text.data(), text.size() + 1, hash);
+}
+
+// A missing file hashes differently from any existing one.
+inline std::uint64_t fileHash(const std::string& path)
+{
+    std::ifstream is(path.c_str(), std::ios::binary);
+    if (!is)
+        return fnv1a("missing " + path);
+    std::uint64_t hash = fnvOffsetBasis;
+    char buffer[64 * 1024];
+    while (is.read(buffer, sizeof(buffer)) || is.gcount() > 0)
+        hash = fnv1a(buffer, std::size_t(is.gcount()), hash);
+    return hash;
+}
+
+// A loaded module, identified by its GNU build ID or, without one, by the
+// contents of its file.
+struct ModuleIdentity
+{
+    std::uintptr_t first, last, bias;
+    std::uint64_t hash;
+};
+
+struct ModuleSearch
+{
+    std::uintptr_t address;
+    ModuleIdentity *module;
+    const char *name;
+    std::uint64_t buildId;
+    bool found, hasBuildId;
+};
+
+// Hashes the GNU build ID of a loaded module, if it has one.
+inline bool hashBuildId(const dl_phdr_info *info, std::uint64_t& hash)
+{
+    for (int i = 0; i != info->dlpi_phnum; ++i)
+    {
+        const ElfW(Phdr)& header = info->dlpi_phdr[i];
+        if (header.p_type != PT_NOTE)
+            continue;
+        const char *note = reinterpret_cast<const char *>(info->dlpi_addr + header.p_vaddr);
+        const char *end = note + header.p_memsz;
+        while (note + sizeof(ElfW(Nhdr)) <= end)
+        {
+            const ElfW(Nhdr) *nhdr = reinterpret_cast<const ElfW(Nhdr) *>(note);
+            const char *name = note + sizeof(ElfW(Nhdr));
+            const char *desc = name + ((nhdr->n_namesz + 3) & ~3u);
+            if (nhdr->n_type == NT_GNU_BUILD_ID && nhdr->n_namesz == 4 && std::memcmp(name, "GNU", 4) == 0)
+            {
+                hash = fnv1a(desc, nhdr->n_descsz);
+                return true;
+            }
+            note = desc + ((nhdr->n_descsz + 3) & ~3u);
+        }
+    }
+    return false;
+}
+
+inline std::uint64_t moduleHash(const dl_phdr_info *info)
+{
+    std::uint64_t hash;
+    if (hashBuildId(info, hash))
+        return hash;
+    return fileHash(info->dlpi_name && *info->dlpi_name ? info->dlpi_name : "/proc/self/exe");
+}
+
+inline int searchModule(dl_phdr_info *info, std::size_t , void *data)
+{
+    ModuleSearch& search = *static_cast<ModuleSearch *>(data);
+    std::uintptr_t first = UINTPTR_MAX, last = 0;
+    for (int i = 0; i != info->dlpi_phnum; ++i)
+    {
+        const ElfW(Phdr)& header = info->dlpi_phdr[i];
+        if (header.p_type != PT_LOAD)
+            continue;
+        first = std::min<std::uintptr_t>(first, info->dlpi_addr + header.p_vaddr);
+        last = std::max<std::uintptr_t>(last, info->dlpi_addr + header.p_vaddr + header.p_memsz);
+    }
+    if (search.address < first || search.address >= last)
+        return 0;
+    search.found = true;
+    search.module->first = first;
+    search.module->last = last;
+    search.module->bias = info->dlpi_addr;
+    search.name = info->dlpi_name;
+    search.hasBuildId = hashBuildId(info, search.buildId);
+    return 1;
+}
+
+inline int collectModuleHash(dl_phdr_info *info, std::size_t , void *data)
+{
+    static_cast<std::vector<std::uint64_t> *>(data)->push_back(moduleHash(info));
+    return 0;
+}
+
+// Hash of every loaded module, independent of the order they were loaded in.
+inline std::uint64_t loadedModulesHash()
+{
+    std::vector<std::uint64_t> hashes;
+    ::dl_iterate_phdr(&collectModuleHash, &hashes);
+    std::sort(hashes.begin(), hashes.end());
+    return fnv1a(hashes.data(), hashes.size() * sizeof(std::uint64_t));
+}
+
+}
+
+// Remembers which specifications passed, so that a later run can report
+// them as cached instead of running them. An entry is keyed by everything
+// known to decide the result:
+//
+// - the module holding the specification function and every module loaded
+//   when the run started, each by its GNU build ID or, when it has none, by
+//   the contents of its file. Rebuilding the specification or any shared
+//   object loaded with it, such as the code under test, changes the key;
+// - the description of the specification, the tag query of the run and
+//   whether leaks are detected;
+// - the contents of every declared input file. A change to any of them
+//   invalidates all entries.
+//
+// The environment, the clock and files which were not declared are not
+// part of the key, so specifications depending on them should not be run
+// with a cache. Only passes are stored; a failing specification always
+// runs again. Entries are empty files named after the key, and removing
+// the directory clears the cache.
+class ResultCache : public IResultCache
+{
+public:
+    explicit ResultCache(const std::string& directory)
+        : directory(directory), inputs(Detail::fnvOffsetBasis), loaded(Detail::loadedModulesHash())
+    {
+        if (::mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST)
+            throw std::runtime_error("cannot create result cache " + directory + ": " + std::strerror(errno));
+    }
+
+    void declareInput(const std::string& path)
+    {
+        inputs = Detail::fnv1a(path, inputs);
+        const std::uint64_t contents = Detail::fileHash(path);
+        inputs = Detail::fnv1a(&contents, sizeof(contents), inputs);
+    }
+
+    virtual std::uint64_t key(SpecificationFunction function, const std::string& description, const std::string& options)
+    {
+        const std::uint64_t module = moduleHash(reinterpret_cast<std::uintptr_t>(function));
+        std::uint64_t hash = Detail::fnv1a(&module, sizeof(module), inputs);
+        hash = Detail::fnv1a(&loaded, sizeof(loaded), hash);
+        hash = Detail::fnv1a(description, hash);
+        return Detail::fnv1a(options, hash);
+    }
+
+    // Modules are looked up again, as a library loaded since may occupy
+    // the addresses of one which was unloaded, and the loaded modules are
+    // hashed again.
+    virtual void forgetModules()
+    {
+        modules.clear();
+        loaded = Detail::loadedModulesHash();
+    }
+
+    virtual bool contains(std::uint64_t key) const
+    {
+        struct stat status;
+        return ::stat(entry(key).c_str(), &status) == 0;
+    }
+
+    virtual void store(std::uint64_t key)
+    {
+        const int fd = ::open(entry(key).c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+private:
+    std::string directory;
+    std::uint64_t inputs, loaded;
+    std::vector<Detail::ModuleIdentity> modules;
+
+    std::string entry(std::uint64_t key) const
+    {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+        return directory + "/" + name;
+    }
+
+    std::uint64_t moduleHash(std::uintptr_t address)
+    {
+        for (const Detail::ModuleIdentity& module : modules)
+            if (address >= module.first && address < module.last)
+                return module.hash;
+        Detail::ModuleIdentity module = { 0, 0, 0, 0 };
+        Detail::ModuleSearch search = { address, &module, nullptr, 0, false, false };
+        ::dl_iterate_phdr(&Detail::searchModule, &search);
+        if (!search.found)
+            throw std::runtime_error("specification function outside of any loaded module");
+        if (search.hasBuildId)
+            module.hash = search.buildId;
+        else
+            module.hash = Detail::fileHash(search.name && *search.name ? search.name : "/proc/self/exe");
+        modules.push_back(module);
+        return module.hash;
+    }
+};
+
+}
+
+#endif // CXXSPEC_RESULTCACHE_HPP
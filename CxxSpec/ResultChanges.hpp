@@ -0,0 +1,111 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_RESULTCHANGES_HPP
+#define CXXSPEC_RESULTCHANGES_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/LeafPath.hpp>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace CxxSpec {
+
+// The failing leaves of every specification of a run. A specification
+// which passed is present with no leaves.
+typedef std::map<std::string, std::set<std::string>> RunResults;
+
+// Records the results of a run. A failure outside of any leaf, such as a
+// leak, is recorded under the name of the specification. Skipped
+// specifications are left out.
+class ResultRecorder : public Detail::LeafPathObserver
+{
+public:
+    virtual void testFailed(const AssertionFailed& )
+    {
+        results_[specification].insert(leafPath.name(specification));
+    }
+
+    virtual void testingSpecification(const std::string& spec)
+    {
+        LeafPathObserver::testingSpecification(spec);
+        results_[spec];
+    }
+
+    virtual void specificationSkipped()
+    {
+        results_.erase(specification);
+    }
+
+    const RunResults& results() const { return results_; }
+
+private:
+    RunResults results_;
+};
+
+struct ResultChanges
+{
+    std::vector<std::string> failing, fixed, stillFailing;
+};
+
+// Compares the leaves of the specifications in the current run only, so a
+// run of a few specifications can be compared with the results of all of
+// them.
+inline ResultChanges compareResults(const RunResults& previous, const RunResults& current)
+{
+    ResultChanges changes;
+    for (const auto& spec : current)
+    {
+        auto before = previous.find(spec.first);
+        const std::set<std::string> none;
+        const std::set<std::string>& failedBefore = before != previous.end() ? before->second : none;
+        for (const std::string& leaf : spec.second)
+            (failedBefore.count(leaf) ? changes.stillFailing : changes.failing).push_back(leaf);
+        for (const std::string& leaf : failedBefore)
+            if (spec.second.count(leaf) == 0)
+                changes.fixed.push_back(leaf);
+    }
+    return changes;
+}
+
+inline void printResultChanges(std::ostream& os, const ResultChanges& changes)
+{
+    for (const std::string& leaf : changes.failing)
+        os << "newly failing: " << leaf << "\n";
+    for (const std::string& leaf : changes.fixed)
+        os << "fixed: " << leaf << "\n";
+    for (const std::string& leaf : changes.stillFailing)
+        os << "still failing: " << leaf << "\n";
+    os << changes.failing.size() << " newly failing, " << changes.fixed.size() << " fixed, "
+        << changes.stillFailing.size() << " still failing" << std::endl;
+}
+
+}
+
+#endif // CXXSPEC_RESULTCHANGES_HPP
@@ -28,6 +28,7 @@
 #ifndef CXXSPEC_SECTIONGUARD_HPP
 #define CXXSPEC_SECTIONGUARD_HPP
 #include <CxxSpec/ISpecificationVisitor.hpp>
+#include <CxxSpec/AllocationCounter.hpp>
 
 namespace CxxSpec {
 
@@ -38,9 +39,31 @@ public:
     explicit SectionGuard(ISpecificationVisitor& sv, const std::string& desc)
         : sv(&sv)
     {
+        AllocationCountingPause pause;
         stepIn = sv.beginSection(desc);
     }
 
+    explicit SectionGuard(ISpecificationVisitor& sv, const char *desc)
+        : sv(&sv)
+    {
+        AllocationCountingPause pause;
+        stepIn = sv.beginSection(desc);
+    }
+
+    SectionGuard(ISpecificationVisitor& sv, const std::string& desc, const SourceLocation& location, const TagSet& tags = TagSet())
+        : sv(&sv)
+    {
+        AllocationCountingPause pause;
+        stepIn = sv.beginSectionAt(desc, tags, location);
+    }
+
+    SectionGuard(ISpecificationVisitor& sv, const char *desc, const SourceLocation& location, const TagSet& tags = TagSet())
+        : sv(&sv)
+    {
+        AllocationCountingPause pause;
+        stepIn = sv.beginSectionAt(desc, tags, location);
+    }
+
     SectionGuard(SectionGuard&& other) : sv(other.sv)
     {
         other.sv = nullptr;
@@ -48,6 +71,7 @@ public:
 
     ~SectionGuard()
     {
+        AllocationCountingPause pause;
         if (sv) sv->endSection();
     }
 
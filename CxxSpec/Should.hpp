@@ -29,6 +29,8 @@
 #define CXXSPEC_SHOULD_HPP
 #include <CxxSpec/AssertionFailed.hpp>
 #include <CxxSpec/Messages.hpp>
+#include <CxxSpec/Matchers.hpp>
+#include <CxxSpec/AllocationCounter.hpp>
 #include <type_traits>
 
 namespace CxxSpec {
@@ -61,18 +63,48 @@ public:
         }
     }
 
+    void allocateAtMost(std::size_t allocations)
+    {
+        if (!AllocationCounter::isEnabled())
+            throwAssertionFailed("cannot count allocations without CxxSpec/AllocationCounting.hpp");
+        AllocationStatistics before = AllocationCounter::current();
+        expr();
+        AllocationStatistics allocated = AllocationCounter::current() - before;
+        if (allocated.allocations > allocations)
+        {
+            AllocationCountingPause pause;
+            std::ostringstream os;
+            os << "expected to allocate at most " << allocations << " times but allocated "
+                << allocated.allocations << " times (" << allocated.bytes << " bytes)";
+            throwAssertionFailed(os.str());
+        }
+    }
+
+    void allocateNothing()
+    {
+        allocateAtMost(0);
+    }
+
 protected:
     Expression expr;
     std::string file;
     int line;
     std::string exprText;
 
-    typedef CxxSpec::Messages<ExpressionType> Messages;
-
     void throwAssertionFailed(const std::string& expectation)
     {
+        AllocationCountingPause pause;
         throw AssertionFailed(file, line, exprText, expectation);
     }
+
+    // Describes the failure only once allocations are no longer counted,
+    // so the message does not count against the measured expression.
+    template <typename Describe>
+    void throwDescribedFailure(Describe describe)
+    {
+        AllocationCountingPause pause;
+        throw AssertionFailed(file, line, exprText, describe());
+    }
 };
 
 template <typename Expression, typename ExpressionType = typename std::result_of<Expression()>::type>
@@ -96,13 +128,67 @@ public:
             Base::throwAssertionFailed("expected to be false but is true");
     }
 
-    void operator==(ExpressionType expected)
+    template <typename Expected>
+    void operator==(const Expected& expected)
     {
-        auto val = Base::expr();
-        if (!(val == expected))
-            Base::throwAssertionFailed(Base::Messages::equalityFailed(val, expected));
+        auto&& actual = Base::expr();
+        if (!(actual == expected))
+            Base::throwDescribedFailure([&] { return Messages<Expected>::equalityFailed(actual, expected); });
     }
 
+    template <typename Expected>
+    void operator!=(const Expected& expected)
+    {
+        auto&& actual = Base::expr();
+        if (!(actual != expected))
+            Base::throwDescribedFailure([&] { return Messages<Expected>::inequalityFailed(actual, expected); });
+    }
+
+    template <typename Expected>
+    void operator<(const Expected& expected)
+    {
+        auto&& actual = Base::expr();
+        if (!(actual < expected))
+            Base::throwDescribedFailure([&] { return Messages<Expected>::comparisonFailed("less than", actual, expected); });
+    }
+
+    template <typename Expected>
+    void operator<=(const Expected& expected)
+    {
+        auto&& actual = Base::expr();
+        if (!(actual <= expected))
+            Base::throwDescribedFailure([&] { return Messages<Expected>::comparisonFailed("less than or equal to", actual, expected); });
+    }
+
+    template <typename Expected>
+    void operator>(const Expected& expected)
+    {
+        auto&& actual = Base::expr();
+        if (!(actual > expected))
+            Base::throwDescribedFailure([&] { return Messages<Expected>::comparisonFailed("greater than", actual, expected); });
+    }
+
+    template <typename Expected>
+    void operator>=(const Expected& expected)
+    {
+        auto&& actual = Base::expr();
+        if (!(actual >= expected))
+            Base::throwDescribedFailure([&] { return Messages<Expected>::comparisonFailed("greater than or equal to", actual, expected); });
+    }
+
+    template <typename M>
+    void match(const Matcher<M>& matcher)
+    {
+        auto&& actual = Base::expr();
+        if (!matcher.derived().matches(actual))
+            Base::throwDescribedFailure([&] { return CxxSpec::Messages<Value>::matchFailed(matcher.description(), actual); });
+    }
+
+private:
+    typedef typename std::remove_cv<typename std::remove_reference<ExpressionType>::type>::type Value;
+
+    template <typename Expected>
+    struct Messages : CxxSpec::Messages<Value, Expected> { };
 };
 
 template <typename Expression>
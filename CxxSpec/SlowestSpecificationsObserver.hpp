@@ -0,0 +1,110 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_SLOWESTSPECIFICATIONSOBSERVER_HPP
+#define CXXSPEC_SLOWESTSPECIFICATIONSOBSERVER_HPP
+#include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/LeafPath.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace CxxSpec {
+
+// Prints the slowest specifications and leaf paths when the run finishes.
+// A leaf is timed over the whole pass that reaches it, including the
+// replayed setup of the sections around it.
+class SlowestSpecificationsObserver : public Detail::LeafPathObserver
+{
+public:
+    explicit SlowestSpecificationsObserver(std::ostream& os, std::size_t count = 10)
+        : os(os), count(count) { }
+
+    virtual void testFailed(const AssertionFailed& ) { }
+
+    virtual void specificationTimed(Timestamp start, Timestamp end, unsigned passes)
+    {
+        std::ostringstream name;
+        name << specification << " (" << passes << (passes == 1 ? " pass)" : " passes)");
+        record(specifications, end - start, name.str());
+    }
+
+    virtual void finishedRun()
+    {
+        if (count == 0)
+            return;
+        print("Slowest specifications:", specifications);
+        print("Slowest leaves:", leaves);
+    }
+
+private:
+    typedef std::pair<TimingClock::duration, std::string> Timed;
+
+    std::ostream& os;
+    std::size_t count;
+    std::vector<Timed> specifications, leaves;
+
+    virtual void leafFinished(Timestamp start, Timestamp end)
+    {
+        record(leaves, end - start, leafPath.name(specification));
+    }
+
+    static bool slower(const Timed& left, const Timed& right)
+    {
+        return left.first > right.first;
+    }
+
+    void record(std::vector<Timed>& slowest, TimingClock::duration duration, const std::string& name)
+    {
+        if (count == 0 || (slowest.size() == count && !(duration > slowest.back().first)))
+            return;
+        const Timed timed(duration, name);
+        slowest.insert(std::upper_bound(slowest.begin(), slowest.end(), timed, &slower), timed);
+        if (slowest.size() > count)
+            slowest.pop_back();
+    }
+
+    void print(const char *title, const std::vector<Timed>& slowest)
+    {
+        if (slowest.empty())
+            return;
+        os << title << std::endl;
+        for (const Timed& timed : slowest)
+        {
+            std::ostringstream milliseconds;
+            milliseconds << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(timed.first).count();
+            os << std::setw(12) << milliseconds.str() << " ms  " << timed.second << std::endl;
+        }
+    }
+};
+
+}
+
+#endif // CXXSPEC_SLOWESTSPECIFICATIONSOBSERVER_HPP
@@ -38,28 +38,82 @@
         ::CxxSpec::SpecificationGuard CxxSpec_specificationGuard(CxxSpec_specificationVisitor);\
         CXXSPEC_CAT(CxxSpec__Specification_impl_at_line_, __LINE__)(CxxSpec_specificationVisitor);\
     } \
-    static int CXXSPEC_CAT(CxxSpec__Specification_register_at_line_, __LINE__) \
-        = (::CxxSpec::registerSpecification(desc, &CXXSPEC_CAT(CxxSpec__Specification_at_line_, __LINE__)), 0); \
+    CXXSPEC_REGISTER_SPECIFICATION(desc, CXXSPEC_CAT(CxxSpec__Specification_at_line_, __LINE__)); \
+    static void CXXSPEC_CAT(CxxSpec__Specification_impl_at_line_, __LINE__)(::CxxSpec::ISpecificationVisitor& CxxSpec_specificationVisitor)
+
+// Tags are given as one string literal, e.g. "slow io". A run selecting
+// tags skips specifications and contexts whose tags, together with those
+// of the enclosing specification and contexts, do not match.
+#define CXXSPEC_DESCRIBE_TAGGED(desc, tags) \
+    static void CXXSPEC_CAT(CxxSpec__Specification_impl_at_line_, __LINE__)(::CxxSpec::ISpecificationVisitor& CxxSpec_specificationVisitor); \
+    static void CXXSPEC_CAT(CxxSpec__Specification_at_line_, __LINE__)(::CxxSpec::ISpecificationVisitor& CxxSpec_specificationVisitor) \
+    { \
+        static const ::CxxSpec::TagSet CxxSpec_specificationTags = ::CxxSpec::parseTags(tags); \
+        ::CxxSpec::SpecificationGuard CxxSpec_specificationGuard(CxxSpec_specificationVisitor, CxxSpec_specificationTags);\
+        CXXSPEC_CAT(CxxSpec__Specification_impl_at_line_, __LINE__)(CxxSpec_specificationVisitor);\
+    } \
+    CXXSPEC_REGISTER_TAGGED_SPECIFICATION(desc, CXXSPEC_CAT(CxxSpec__Specification_at_line_, __LINE__), tags); \
     static void CXXSPEC_CAT(CxxSpec__Specification_impl_at_line_, __LINE__)(::CxxSpec::ISpecificationVisitor& CxxSpec_specificationVisitor)
 
+// With CXXSPEC_USE_SECTION_REGISTRATION a specification is registered by a
+// constant descriptor placed in a dedicated section, which the registry
+// reads in place. Descriptions must then be string literals.
+#ifdef CXXSPEC_USE_SECTION_REGISTRATION
+#define CXXSPEC_REGISTER_TAGGED_SPECIFICATION(desc, function, tags) \
+    static const ::CxxSpec::SpecificationDescriptor CXXSPEC_CAT(CxxSpec__Specification_descriptor_at_line_, __LINE__) \
+        __attribute__((used, section(CXXSPEC_SPECIFICATION_SECTION), aligned(__alignof__(::CxxSpec::SpecificationDescriptor)))) \
+        = { desc, &function, __FILE__, __LINE__, tags }
+#define CXXSPEC_REGISTER_SPECIFICATION(desc, function) CXXSPEC_REGISTER_TAGGED_SPECIFICATION(desc, function, nullptr)
+#else
+#define CXXSPEC_REGISTER_TAGGED_SPECIFICATION(desc, function, tags) \
+    static int CXXSPEC_CAT(CxxSpec__Specification_register_at_line_, __LINE__) \
+        = (::CxxSpec::registerSpecification(desc, &function, ::CxxSpec::SourceLocation(__FILE__, __LINE__), tags), 0)
+#define CXXSPEC_REGISTER_SPECIFICATION(desc, function) \
+    static int CXXSPEC_CAT(CxxSpec__Specification_register_at_line_, __LINE__) \
+        = (::CxxSpec::registerSpecification(desc, &function, ::CxxSpec::SourceLocation(__FILE__, __LINE__)), 0)
+#endif
+#define CXXSPEC_SPECIFICATION_SECTION "cxxspec_specifications"
+
 #define CXXSPEC_CONTEXT(desc) \
-    if (auto CxxSpec_sectionGuard = ::CxxSpec::SectionGuard(CxxSpec_specificationVisitor, desc))
+    if (auto CxxSpec_sectionGuard = ::CxxSpec::SectionGuard(CxxSpec_specificationVisitor, desc, ::CxxSpec::SourceLocation(__FILE__, __LINE__)))
+
+#define CXXSPEC_CONTEXT_TAGGED(desc, tags) \
+    if (auto CxxSpec_sectionGuard = ::CxxSpec::SectionGuard(CxxSpec_specificationVisitor, desc, ::CxxSpec::SourceLocation(__FILE__, __LINE__), \
+        []() -> const ::CxxSpec::TagSet& { static const ::CxxSpec::TagSet parsed = ::CxxSpec::parseTags(tags); return parsed; }()))
 
 namespace CxxSpec {
 
 typedef void (*SpecificationFunction)(ISpecificationVisitor&);
 
+struct SpecificationDescriptor
+{
+    const char *description;
+    SpecificationFunction function;
+    const char *file;
+    unsigned line;
+    const char *tags;
+};
+
 class SpecificationGuard
 {
 public:
     explicit SpecificationGuard(ISpecificationVisitor& sv)
         : sv(sv)
     {
+        AllocationCountingPause pause;
         sv.beginSpecification();
     }
 
+    SpecificationGuard(ISpecificationVisitor& sv, const TagSet& tags)
+        : sv(sv)
+    {
+        AllocationCountingPause pause;
+        sv.beginTaggedSpecification(tags);
+    }
+
     ~SpecificationGuard()
     {
+        AllocationCountingPause pause;
         sv.endSpecification();
     }
 
@@ -0,0 +1,366 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_SPECIFICATIONDAEMON_HPP
+#define CXXSPEC_SPECIFICATIONDAEMON_HPP
+#include <CxxSpec/ChangedFiles.hpp>
+#include <CxxSpec/ConsoleSpecificationObserver.hpp>
+#include <CxxSpec/FailedLeaves.hpp>
+#include <CxxSpec/JsonLinesSpecificationObserver.hpp>
+#include <CxxSpec/MultiplexingSpecificationObserver.hpp>
+#include <CxxSpec/PerformanceCounterGroup.hpp>
+#include <CxxSpec/SpecificationRegistry.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+// Writes a stream to a file descriptor, one write(2) per flush.
+class FileDescriptorBuffer : public std::streambuf
+{
+public:
+    explicit FileDescriptorBuffer(int fd) : fd(fd)
+    {
+        setp(buffer, buffer + sizeof(buffer));
+    }
+
+    ~FileDescriptorBuffer()
+    {
+        sync();
+    }
+
+protected:
+    virtual int overflow(int c)
+    {
+        if (sync() != 0)
+            return traits_type::eof();
+        if (c != traits_type::eof())
+            sputc(char(c));
+        return traits_type::not_eof(c);
+    }
+
+    virtual int sync()
+    {
+        for (const char *next = pbase(); next != pptr(); )
+        {
+            const ssize_t written = ::write(fd, next, pptr() - next);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return -1;
+            next += written;
+        }
+        setp(buffer, buffer + sizeof(buffer));
+        return 0;
+    }
+
+private:
+    int fd;
+    char buffer[4096];
+};
+
+inline sockaddr_un socketAddress(const std::string& path)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("socket path too long: " + path);
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return address;
+}
+
+}
+
+// A request to run specifications, sent as "key value" lines ended by an
+// empty line:
+//
+//     tags smoke & !io
+//     spec parser<TAB>numbers<TAB>negative
+//     changed /src/parser.cpp
+//     dependencies /build/parser.d
+//     reporter jsonlines
+//     counters
+//
+// Every key is optional and spec, changed and dependencies may be
+// repeated. A spec names a specification to run, optionally followed by
+// the tab separated contexts leading to the leaf or subtree to run alone,
+// escaped as in the failed leaves file. The reporter is "console", the
+// default, or "jsonlines".
+struct RunRequest
+{
+    std::string tags, reporter;
+    RecordedLeaves specs;
+    std::vector<std::string> changed, dependencies;
+    bool counters;
+
+    RunRequest() : reporter("console"), counters(false) { }
+
+    static RunRequest parse(const std::string& text)
+    {
+        RunRequest request;
+        std::string::size_type first = 0;
+        while (first < text.size())
+        {
+            std::string::size_type end = text.find('\n', first);
+            if (end == std::string::npos)
+                end = text.size();
+            const std::string line = text.substr(first, end - first);
+            first = end + 1;
+            if (line.empty())
+                break;
+            const std::string::size_type space = line.find(' ');
+            const std::string key = line.substr(0, space);
+            const std::string value = space == std::string::npos ? std::string() : line.substr(space + 1);
+            if (key == "tags")
+                request.tags = value;
+            else if (key == "spec" && !value.empty())
+            {
+                const std::vector<std::string> fields = Detail::readLeafFields(value);
+                const RecordedLeaf spec = { fields.front(), std::vector<std::string>(fields.begin() + 1, fields.end()) };
+                request.specs.push_back(spec);
+            }
+            else if (key == "changed")
+                request.changed.push_back(value);
+            else if (key == "dependencies")
+                request.dependencies.push_back(value);
+            else if (key == "reporter" && (value == "console" || value == "jsonlines"))
+                request.reporter = value;
+            else if (key == "counters" && value.empty())
+                request.counters = true;
+            else
+                throw std::invalid_argument("invalid request line: " + line);
+        }
+        return request;
+    }
+};
+
+// Serves runs of the specifications of a registry on a Unix domain socket.
+// The process initializes once, and each connection is handled by a child
+// forked from that state, so a run does not pay for dynamic linking,
+// registration or global fixtures again. The child reads the request,
+// streams the report back over the connection and closes it. The daemon
+// must be single threaded when it forks.
+class SpecificationDaemon
+{
+public:
+    SpecificationDaemon(const SpecificationDaemon& ) = delete;
+    SpecificationDaemon& operator=(const SpecificationDaemon& ) = delete;
+
+    SpecificationDaemon(const std::string& path, SpecificationRegistry& registry = SpecificationRegistry::getInstance())
+        : path(path), registry(registry), listening(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0))
+    {
+        if (listening < 0)
+            throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+        const sockaddr_un address = Detail::socketAddress(path);
+        ::unlink(path.c_str());
+        if (::bind(listening, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || ::listen(listening, 16) != 0)
+        {
+            const std::string error = std::strerror(errno);
+            ::close(listening);
+            throw std::runtime_error("cannot listen on " + path + ": " + error);
+        }
+    }
+
+    // Waits for the runs still streaming their reports.
+    ~SpecificationDaemon()
+    {
+        ::close(listening);
+        ::unlink(path.c_str());
+        for (pid_t child : children)
+            while (::waitpid(child, nullptr, 0) < 0 && errno == EINTR) { }
+    }
+
+    void serve()
+    {
+        for (;;)
+            if (waitForConnection(std::chrono::seconds(1)))
+                acceptRun();
+    }
+
+    // Waits up to timeout for a connection. Children which finished are
+    // reaped either way, so they do not linger while the daemon is idle.
+    bool waitForConnection(std::chrono::milliseconds timeout)
+    {
+        pollfd incoming = { listening, POLLIN, 0 };
+        const int ready = ::poll(&incoming, 1, int(timeout.count()));
+        if (ready < 0 && errno != EINTR)
+            throw std::runtime_error(std::string("poll: ") + std::strerror(errno));
+        reapChildren();
+        return ready > 0;
+    }
+
+    // Accepts one connection and forks the child running it. Children
+    // which finished are reaped. Only the children forked here are waited
+    // for, so processes started by fixtures or the host are left alone.
+    void acceptRun()
+    {
+        const int connection = ::accept4(listening, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0)
+        {
+            if (errno != EINTR && errno != ECONNABORTED)
+                throw std::runtime_error(std::string("accept: ") + std::strerror(errno));
+            return;
+        }
+        const pid_t child = ::fork();
+        if (child == 0)
+        {
+            ::close(listening);
+            ::_exit(run(connection));
+        }
+        ::close(connection);
+        if (child > 0)
+            children.push_back(child);
+        reapChildren();
+        if (child < 0)
+            throw std::runtime_error(std::string("fork: ") + std::strerror(errno));
+    }
+
+private:
+    class FailureCounter : public ISpecificationObserver
+    {
+    public:
+        FailureCounter() : failures(0) { }
+
+        virtual void testFailed(const AssertionFailed& ) { ++failures; }
+        virtual void testingSpecification(const std::string& ) { }
+        virtual void enteredContext(const std::string& ) { }
+        virtual void leftContext() { }
+
+        unsigned failures;
+    };
+
+    const std::string path;
+    SpecificationRegistry& registry;
+    const int listening;
+    std::vector<pid_t> children;
+
+    void reapChildren()
+    {
+        children.erase(std::remove_if(children.begin(), children.end(), [](pid_t child)
+        {
+            return ::waitpid(child, nullptr, WNOHANG) != 0;
+        }), children.end());
+    }
+
+    static std::string readRequest(int connection)
+    {
+        std::string text;
+        char buffer[1024];
+        while (text.find("\n\n") == std::string::npos && text != "\n")
+        {
+            const ssize_t length = ::read(connection, buffer, sizeof(buffer));
+            if (length < 0 && errno == EINTR)
+                continue;
+            if (length <= 0)
+                break;
+            text.append(buffer, length);
+        }
+        return text;
+    }
+
+    // Whole specifications are selected by description, and those with
+    // contexts are run as leaves before them.
+    void selectSpecifications(const RecordedLeaves& specs)
+    {
+        if (specs.empty())
+            return;
+        std::set<std::string> whole;
+        RecordedLeaves leaves;
+        for (const RecordedLeaf& spec : specs)
+            if (spec.contexts.empty())
+                whole.insert(spec.specification);
+            else
+                leaves.push_back(spec);
+        registry.selectDescriptions(whole);
+        registry.runLeavesFirst(leaves, whole.empty());
+    }
+
+    // Runs in the child, so it returns an exit status instead of throwing.
+    int run(int connection)
+    {
+        Detail::FileDescriptorBuffer buffer(connection);
+        std::ostream os(&buffer);
+        try
+        {
+            const RunRequest request = RunRequest::parse(readRequest(connection));
+            if (!request.tags.empty())
+                registry.selectTags(request.tags);
+            selectSpecifications(request.specs);
+            if (!request.changed.empty())
+            {
+                ChangedFileSelection selection(request.changed);
+                for (const std::string& rules : request.dependencies)
+                {
+                    std::ifstream is(rules.c_str());
+                    if (!is)
+                        throw std::runtime_error("cannot open " + rules);
+                    selection.readDependencies(is);
+                }
+                registry.selectChangedFiles(selection);
+            }
+            if (request.counters)
+                registry.measureCounters(&openPerformanceCounters);
+            auto failures = std::make_shared<FailureCounter>();
+            auto so = std::make_shared<MultiplexingSpecificationObserver>();
+            if (request.reporter == "jsonlines")
+                so->add(std::make_shared<JsonLinesSpecificationObserver>(connection));
+            else
+                so->add(std::make_shared<ConsoleSpecificationObserver>(os));
+            so->add(failures);
+            registry.runAll([&]{ return std::make_shared<SpecificationExecutor>(so); }, so);
+            return failures->failures == 0 ? 0 : 1;
+        }
+        catch (const std::exception& e)
+        {
+            os << "cxxspec: " << e.what() << std::endl;
+            return 2;
+        }
+    }
+};
+
+}
+
+#endif // CXXSPEC_SPECIFICATIONDAEMON_HPP
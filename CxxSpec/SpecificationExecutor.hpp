@@ -29,6 +29,8 @@
 #define CXXSPEC_SPECIFICATIONEXECUTOR_HPP
 #include <CxxSpec/ISpecificationVisitor.hpp>
 #include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/Timing.hpp>
+#include <utility>
 #include <vector>
 
 namespace CxxSpec {
@@ -37,14 +39,21 @@ class SpecificationExecutor : public ISpecificationVisitor
 {
 public:
     SpecificationExecutor(std::shared_ptr<ISpecificationObserver> observer)
-        : assumeMoreSectionsToVisit(false), observer(observer)
+        : siblings(1, 0), assumeMoreSectionsToVisit(false), observer(observer), selecting(false), followingPath(false)
     {
         markEnterFirstSection();
     }
 
     virtual void beginSpecification()
     {
+        beginTaggedSpecification(TagSet());
+    }
+
+    virtual void beginTaggedSpecification(const TagSet& tags)
+    {
+        specificationTags = tags;
         state = State::following();
+        siblings.assign(1, 0);
 
         followNextPath();
         markEnterFirstSection();
@@ -56,12 +65,44 @@ public:
 
     virtual bool beginSection(const std::string& desc)
     {
-        return state.beginSection(*this, desc);
+        return beginSectionAt(desc, TagSet(), SourceLocation());
+    }
+
+    // An excluded section is invisible to the state machine: it is neither
+    // entered nor counted as a sibling, so no pass is spent on it.
+    virtual bool beginSectionAt(const std::string& desc, const TagSet& tags, const SourceLocation& location)
+    {
+        const std::size_t depth = openSections.size();
+        const TagSet accumulated = (depth ? openSections.back().tags : specificationTags) | tags;
+        if ((selecting && tags.any() && !query.matches(accumulated)) ||
+            (followingPath && depth < selectedPath.size() && desc != selectedPath[depth]))
+        {
+            openSections.push_back(OpenSection::excluded());
+            return false;
+        }
+        const int index = siblings[depth]++;
+        sectionLocation = location;
+        if (!state.beginSection(*this, desc))
+        {
+            openSections.push_back(OpenSection());
+            return false;
+        }
+        countEntry(depth, index);
+        siblings.resize(depth + 2);
+        siblings[depth + 1] = 0;
+        openSections.push_back(OpenSection(desc, TimingClock::now(), accumulated));
+        return true;
     }
 
     virtual void endSection()
     {
+        const OpenSection section = openSections.back();
+        openSections.pop_back();
+        if (section.skipped)
+            return;
         state.endSection(*this);
+        if (section.entered && observer)
+            observer->sectionTimed(section.desc, section.start, TimingClock::now(), entries[openSections.size()].second);
     }
 
     virtual bool done() const
@@ -75,6 +116,20 @@ public:
             assumeMoreSectionsToVisit = true;
     }
 
+    virtual void selectTags(const TagQuery& selected)
+    {
+        query = selected;
+        selecting = true;
+    }
+
+    // Excludes the sections off the path of contexts, so the passes go
+    // straight down to the leaf it names and through any sections below.
+    virtual void selectPath(const std::vector<std::string>& path)
+    {
+        selectedPath = path;
+        followingPath = true;
+    }
+
 private:
 
     struct State
@@ -135,10 +190,49 @@ private:
         bool moreSectionsPossible() const { return moreSectionsPossible_; }
     };
 
+    struct OpenSection
+    {
+        bool entered, skipped;
+        std::string desc;
+        Timestamp start;
+        TagSet tags;
+
+        OpenSection() : entered(false), skipped(false) { }
+        OpenSection(const std::string& desc, Timestamp start, const TagSet& tags)
+            : entered(true), skipped(false), desc(desc), start(start), tags(tags) { }
+
+        static OpenSection excluded()
+        {
+            OpenSection section;
+            section.skipped = true;
+            return section;
+        }
+    };
+
     State state;
     std::vector<int> currentPath, nextPath;
+    std::vector<int> siblings;
+    std::vector<OpenSection> openSections;
+    std::vector<std::pair<int, unsigned>> entries;
     bool assumeMoreSectionsToVisit;
     std::shared_ptr<ISpecificationObserver> observer;
+    TagSet specificationTags;
+    SourceLocation sectionLocation;
+    TagQuery query;
+    bool selecting;
+    std::vector<std::string> selectedPath;
+    bool followingPath;
+
+    void countEntry(std::size_t depth, int index)
+    {
+        if (depth < entries.size() && entries[depth].first == index)
+        {
+            ++entries[depth].second;
+            return;
+        }
+        entries.resize(depth);
+        entries.push_back(std::make_pair(index, 1u));
+    }
 
     void followNextPath()
     {
@@ -176,7 +270,7 @@ private:
 
     void enteredContext(const std::string& desc)
     {
-        if (observer) observer->enteredContext(desc);
+        if (observer) observer->enteredContextAt(desc, sectionLocation);
     }
 
     bool following_beginSection(const std::string& desc)
@@ -0,0 +1,179 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_SPECIFICATIONHOST_HPP
+#define CXXSPEC_SPECIFICATIONHOST_HPP
+#include <CxxSpec/HostFixtures.hpp>
+#include <CxxSpec/SpecificationLibrary.hpp>
+#include <CxxSpec/SpecificationRegistry.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+// Identifies the contents of a file by its inode, size and modification
+// time, which a rebuild changes whether it rewrites or replaces the file.
+struct FileVersion
+{
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    timespec modified;
+
+    static FileVersion of(const std::string& path)
+    {
+        struct stat status;
+        FileVersion version = { };
+        if (::stat(path.c_str(), &status) == 0)
+        {
+            version.device = status.st_dev;
+            version.inode = status.st_ino;
+            version.size = status.st_size;
+            version.modified = status.st_mtim;
+        }
+        return version;
+    }
+
+    friend bool operator==(const FileVersion& left, const FileVersion& right)
+    {
+        return left.device == right.device && left.inode == right.inode && left.size == right.size &&
+            left.modified.tv_sec == right.modified.tv_sec && left.modified.tv_nsec == right.modified.tv_nsec;
+    }
+};
+
+}
+
+// Keeps specification libraries loaded and registered in a long-lived
+// process and replaces those which were rebuilt, so a rerun after an edit
+// only pays for loading the changed suite. Fixtures provided by the host
+// survive the reloads. Libraries are loaded from private copies, since
+// loading the same path again returns the old library if the dynamic
+// loader could not unload it.
+class SpecificationHost
+{
+public:
+    SpecificationHost(const SpecificationHost& ) = delete;
+    SpecificationHost& operator=(const SpecificationHost& ) = delete;
+
+    explicit SpecificationHost(SpecificationRegistry& registry) : registry(registry) { }
+
+    ~SpecificationHost()
+    {
+        for (const Loaded& loaded : libraries)
+            registry.unregisterSpecifications(loaded.library->specifications());
+    }
+
+    HostFixtures& fixtures() { return fixtures_; }
+
+    void load(const std::string& path)
+    {
+        Loaded loaded = { path, Detail::FileVersion::of(path), loadCopy(path) };
+        registry.registerSpecifications(loaded.library->specifications());
+        libraries.push_back(std::move(loaded));
+    }
+
+    std::vector<std::string> changedLibraries() const
+    {
+        std::vector<std::string> changed;
+        for (const Loaded& loaded : libraries)
+            if (!(Detail::FileVersion::of(loaded.path) == loaded.version))
+                changed.push_back(loaded.path);
+        return changed;
+    }
+
+    // Replaces the library loaded from the path. If the new library cannot
+    // be loaded, the old one stays registered.
+    void reload(const std::string& path)
+    {
+        for (Loaded& loaded : libraries)
+        {
+            if (loaded.path != path)
+                continue;
+            const Detail::FileVersion version = Detail::FileVersion::of(path);
+            std::unique_ptr<SpecificationLibrary> library = loadCopy(path);
+            registry.unregisterSpecifications(loaded.library->specifications());
+            registry.registerSpecifications(library->specifications());
+            loaded.library.swap(library);
+            loaded.version = version;
+            return;
+        }
+        throw std::invalid_argument("not loaded: " + path);
+    }
+
+private:
+    struct Loaded
+    {
+        std::string path;
+        Detail::FileVersion version;
+        std::unique_ptr<SpecificationLibrary> library;
+    };
+
+    SpecificationRegistry& registry;
+    HostFixtures fixtures_;
+    std::vector<Loaded> libraries;
+
+    std::unique_ptr<SpecificationLibrary> loadCopy(const std::string& path)
+    {
+        char copy[] = "/tmp/cxxspec-library-XXXXXX";
+        const int fd = ::mkstemp(copy);
+        if (fd < 0)
+            throw std::runtime_error("cannot copy " + path);
+        ::close(fd);
+        std::unique_ptr<SpecificationLibrary> library;
+        try
+        {
+            std::ifstream in(path.c_str(), std::ios::binary);
+            std::ofstream out(copy, std::ios::binary);
+            if (!in || !(out << in.rdbuf()) || !out.flush())
+                throw std::runtime_error("cannot copy " + path);
+            library.reset(new SpecificationLibrary(copy, SpecificationLibrary::suiteName(path)));
+        }
+        catch (...)
+        {
+            ::unlink(copy);
+            throw;
+        }
+        ::unlink(copy);
+        typedef void (*Attach)(HostFixtures *);
+        if (const Attach attach = reinterpret_cast<Attach>(library->symbol("cxxspec_attachHostFixtures")))
+            attach(&fixtures_);
+        return library;
+    }
+};
+
+}
+
+#endif // CXXSPEC_SPECIFICATIONHOST_HPP
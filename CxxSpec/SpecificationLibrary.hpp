@@ -0,0 +1,103 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_SPECIFICATIONLIBRARY_HPP
+#define CXXSPEC_SPECIFICATIONLIBRARY_HPP
+#include <CxxSpec/LinkedSpecifications.hpp>
+#include <stdexcept>
+#include <string>
+#include <dlfcn.h>
+
+namespace CxxSpec {
+
+// A shared object whose specifications were built with
+// CXXSPEC_USE_SECTION_REGISTRATION. Loading it runs no initializer per
+// specification, and its descriptors are read in place, so the library
+// must outlive every run of them. Unless given a name, the suite is named
+// after the file, so libparser.so holds the suite "parser".
+class SpecificationLibrary
+{
+public:
+    SpecificationLibrary(const SpecificationLibrary& ) = delete;
+    SpecificationLibrary& operator=(const SpecificationLibrary& ) = delete;
+
+    explicit SpecificationLibrary(const std::string& path) : suite_(suiteName(path))
+    {
+        load(path);
+    }
+
+    SpecificationLibrary(const std::string& path, const std::string& suite) : suite_(suite)
+    {
+        load(path);
+    }
+
+    ~SpecificationLibrary()
+    {
+        ::dlclose(handle);
+    }
+
+    const std::string& suite() const { return suite_; }
+    SpecificationDescriptors specifications() const { return specifications_; }
+
+    void *symbol(const char *name) const
+    {
+        return ::dlsym(handle, name);
+    }
+
+    static std::string suiteName(const std::string& path)
+    {
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        if (name.compare(0, 3, "lib") == 0)
+            name.erase(0, 3);
+        return name.substr(0, name.find('.'));
+    }
+
+private:
+    std::string suite_;
+    void *handle;
+    SpecificationDescriptors specifications_;
+
+    void load(const std::string& path)
+    {
+        handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!handle)
+            throw std::runtime_error(::dlerror());
+        typedef SpecificationDescriptors (*Entry)();
+        const Entry entry = reinterpret_cast<Entry>(::dlsym(handle, "cxxspec_linkedSpecifications"));
+        if (!entry)
+        {
+            ::dlclose(handle);
+            throw std::runtime_error("not a specification library: " + path);
+        }
+        specifications_ = entry();
+        specifications_.suite = suite_.c_str();
+    }
+};
+
+}
+
+#endif // CXXSPEC_SPECIFICATIONLIBRARY_HPP
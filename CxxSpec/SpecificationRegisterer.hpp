@@ -36,6 +36,12 @@ inline void registerSpecification(const std::string& desc, SpecificationFunction
     SpecificationRegistry::getInstance().registerSpecification(desc, func);
 }
 
+inline void registerSpecification(
+    const std::string& desc, SpecificationFunction func, const SourceLocation& location, const char *tags = nullptr)
+{
+    SpecificationRegistry::getInstance().registerSpecification(desc, func, location, tags);
+}
+
 }
 
 #endif // CXXSPEC_SPECIFICATIONREGISTERER_HPP
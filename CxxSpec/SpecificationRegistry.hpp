@@ -32,50 +32,511 @@
 #include <CxxSpec/SpecificationExecutor.hpp>
 #include <CxxSpec/ISpecificationObserver.hpp>
 #include <CxxSpec/Assert.hpp>
+#include <CxxSpec/ICoverageRecorder.hpp>
+#include <CxxSpec/IResultCache.hpp>
+#include <CxxSpec/LeakDetector.hpp>
+#include <CxxSpec/LinkedSpecifications.hpp>
+#include <CxxSpec/PerformanceCounters.hpp>
+#include <CxxSpec/RecordedLeaf.hpp>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <vector>
 #include <algorithm>
 
 namespace CxxSpec
 {
 
+// Specifications with a higher priority are started first.
+typedef std::function<double(const std::string& description, const SourceLocation& location)> SpecificationPriority;
 
+// Decides whether a specification is selected to run.
+typedef std::function<bool(const std::string& description, const SourceLocation& location)> SpecificationFilter;
 
 class SpecificationRegistry
 {
 public:
 
+    SpecificationRegistry()
+        : tagSelection(false), descriptionSelecting(false), leakDetection(true),
+        leavesOnly(false), jobs(1), timeBudget(TimingClock::duration::zero()), budgeted(false) { }
+
     static SpecificationRegistry& getInstance()
     {
-        static SpecificationRegistry registry;
+        static SpecificationRegistry registry(Detail::linkedSpecifications());
         return registry;
     }
 
     void registerSpecification(const std::string& desc, SpecificationFunction f)
     {
-        specs.push_back({ desc, f });
+        specs.push_back({ desc, f, TagSet(), SourceLocation() });
+    }
+
+    void registerSpecification(
+        const std::string& desc, SpecificationFunction f, const SourceLocation& location, const char *tags = nullptr)
+    {
+        specs.push_back({ desc, f, parseTags(tags), location });
+    }
+
+    // The descriptors must outlive the registry. They run before the
+    // specifications registered one by one. Their order, descriptions and
+    // tags are resolved here, so a run only tests each tag set.
+    void registerSpecifications(SpecificationDescriptors descriptors)
+    {
+        if (descriptors.first == descriptors.last)
+            return;
+        AllocationCountingPause pause;
+        DescribedSpecifications described = { descriptors, std::vector<Specification>() };
+        for (const SpecificationDescriptor *descriptor : Detail::orderedSpecifications(descriptors))
+        {
+            std::string description = descriptor->description;
+            if (descriptors.suite)
+                description = std::string(descriptors.suite) + ": " + description;
+            const Specification spec = {
+                description, descriptor->function, parseTags(descriptor->tags), SourceLocation(descriptor->file, descriptor->line) };
+            described.specs.push_back(spec);
+        }
+        descriptorRanges.push_back(described);
+    }
+
+    // Forgets descriptors registered with registerSpecifications, so the
+    // library holding them can be unloaded.
+    void unregisterSpecifications(SpecificationDescriptors descriptors)
+    {
+        descriptorRanges.erase(
+            std::remove_if(descriptorRanges.begin(), descriptorRanges.end(), [&](const DescribedSpecifications& registered)
+            {
+                return registered.descriptors.first == descriptors.first && registered.descriptors.last == descriptors.last;
+            }),
+            descriptorRanges.end());
+    }
+
+    // Runs only the specifications and contexts whose tags match the query,
+    // e.g. "smoke & !io". Tags of a context narrow the selection within a
+    // selected specification.
+    void selectTags(const std::string& query)
+    {
+        tagQuery = TagQuery(query);
+        tagSelection = true;
+        selectedTags = query;
+    }
+
+    // Runs only the specifications with one of the given descriptions.
+    void selectDescriptions(const std::set<std::string>& descriptions)
+    {
+        selectedDescriptions = descriptions;
+        descriptionSelecting = true;
+    }
+
+    // Runs only the specifications defined in changed files, as selected
+    // by a ChangedFileSelection from CxxSpec/ChangedFiles.hpp.
+    void selectChangedFiles(SpecificationFilter selection)
+    {
+        fileSelection = selection;
+    }
+
+    void selectAllFiles()
+    {
+        fileSelection = SpecificationFilter();
+    }
+
+    // Runs only the specifications whose recorded coverage enters changed
+    // code, as selected by a CoverageImpact from CxxSpec/Coverage.hpp.
+    void selectCoverageImpact(SpecificationFilter impact)
+    {
+        coverageImpact = impact;
+    }
+
+    // Records what each specification which runs covers.
+    void collectCoverage(std::shared_ptr<ICoverageRecorder> recorder)
+    {
+        coverage = recorder;
     }
+
+    // Runs the recorded leaves before any specification, each driven
+    // straight down its contexts, and then the selected specifications
+    // unless only the leaves are run. Leaves of specifications which are no
+    // longer registered are ignored.
+    void runLeavesFirst(const RecordedLeaves& leaves, bool onlyLeaves)
+    {
+        leafPaths.clear();
+        for (const RecordedLeaf& leaf : leaves)
+            leafPaths[leaf.specification].push_back(leaf.contexts);
+        leavesOnly = onlyLeaves;
+    }
+
+    // Runs the specifications on the given number of threads, each taking
+    // the next specification when it finishes one. The observer has to
+    // accept events from any thread, as MultiplexingSpecificationObserver
+    // does. Leaks are not detected in a parallel run, and a run recording
+    // coverage stays on one thread.
+    void runJobs(unsigned count)
+    {
+        jobs = count;
+    }
+
+    // Starts the specifications expected to take longest first, so that no
+    // long one is left to run alone at the end of a parallel run. The
+    // history estimates durations by description, as DurationHistory does.
+    template <typename History>
+    void scheduleLongestFirst(std::shared_ptr<History> history)
+    {
+        prioritize([history](const std::string& description, const SourceLocation& )
+        {
+            return double(history->estimate(description));
+        });
+    }
+
+    void prioritize(SpecificationPriority specificationPriority)
+    {
+        priority = specificationPriority;
+    }
+
+    // Starts no specification once the budget has passed since the run
+    // started. The specifications left are reported as skipped at the end
+    // of the run.
+    void limitTime(TimingClock::duration budget)
+    {
+        timeBudget = budget;
+        budgeted = true;
+    }
+
+    void detectLeaks(bool enabled)
+    {
+        leakDetection = enabled;
+    }
+
+    // Reports the counters of every pass and specification, read from a
+    // group each running thread opens, e.g. with openPerformanceCounters
+    // from CxxSpec/PerformanceCounterGroup.hpp. Each pass costs one reading
+    // when it starts and one when it ends. An empty factory measures
+    // nothing.
+    void measureCounters(PerformanceCounterFactory openCounters)
+    {
+        counterFactory = openCounters;
+    }
+
+    // Reports specifications which passed before with the same key as
+    // cached instead of running them, and stores those which pass.
+    void cacheResults(std::shared_ptr<IResultCache> cache)
+    {
+        resultCache = cache;
+    }
+
     void runAll(ISpecificationVisitorFactory specificationVisitorFactory, std::shared_ptr<ISpecificationObserver> so)
     {
-        for (auto spec : specs)
+        const Timestamp deadline = TimingClock::now() + timeBudget;
+        std::unique_ptr<IPerformanceCounterGroup> counters;
+        if (counterFactory)
         {
-            so->testingSpecification(spec.first);
-            std::shared_ptr<ISpecificationVisitor> specificationVisitor = specificationVisitorFactory();
-            do {
-                try
-                {
-                    spec.second(*specificationVisitor);
-                }
-                catch (const AssertionFailed& af)
+            AllocationCountingPause pause;
+            counters = counterFactory();
+        }
+        if (resultCache)
+        {
+            AllocationCountingPause pause;
+            resultCache->forgetModules();
+            cacheOptions.clear();
+            if (tagSelection)
+                cacheOptions = "tags " + selectedTags;
+            if (leakDetection && !parallel() && AllocationCounter::isEnabled())
+                cacheOptions += " leaks";
+        }
+        if (!leafPaths.empty())
+            forEachSpecification([&](const Specification& spec)
+            {
+                auto found = leafPaths.find(spec.description);
+                if (found != leafPaths.end())
+                    for (const std::vector<std::string>& path : found->second)
+                        runAndFinishLeaf(spec, path, specificationVisitorFactory, *so, counters.get());
+            });
+        const bool runningRest = leafPaths.empty() || !leavesOnly;
+        if (runningRest && (parallel() || priority || budgeted))
+            runScheduled(specificationVisitorFactory, *so, deadline);
+        else if (runningRest)
+            forEachSpecification([&](const Specification& spec)
+            {
+                runAndFinishSpecification(spec, specificationVisitorFactory, *so, counters.get());
+            });
+        AllocationCountingPause pause;
+        so->finishedRun();
+    }
+private:
+    struct Specification
+    {
+        std::string description;
+        SpecificationFunction function;
+        TagSet tags;
+        SourceLocation location;
+    };
+
+    struct DescribedSpecifications
+    {
+        SpecificationDescriptors descriptors;
+        std::vector<Specification> specs;
+    };
+
+    std::vector<Specification> specs;
+    std::vector<DescribedSpecifications> descriptorRanges;
+    TagQuery tagQuery;
+    bool tagSelection;
+    std::string selectedTags;
+    std::set<std::string> selectedDescriptions;
+    bool descriptionSelecting;
+    SpecificationFilter fileSelection;
+    SpecificationFilter coverageImpact;
+    std::shared_ptr<ICoverageRecorder> coverage;
+    bool leakDetection;
+    PerformanceCounterFactory counterFactory;
+    std::shared_ptr<IResultCache> resultCache;
+    std::string cacheOptions;
+    std::map<std::string, std::vector<std::vector<std::string>>> leafPaths;
+    bool leavesOnly;
+    unsigned jobs;
+    SpecificationPriority priority;
+    TimingClock::duration timeBudget;
+    bool budgeted;
+
+    explicit SpecificationRegistry(SpecificationDescriptors linked) : SpecificationRegistry()
+    {
+        registerSpecifications(linked);
+    }
+
+    template <typename F>
+    void forEachSpecification(F f)
+    {
+        for (const DescribedSpecifications& described : descriptorRanges)
+            for (const Specification& spec : described.specs)
+                f(spec);
+        for (const auto& spec : specs)
+            f(spec);
+    }
+
+    struct ScheduledSpecification
+    {
+        Specification spec;
+        std::uint64_t cacheKey;
+        double priority;
+    };
+
+    // The selection and the cache are consulted before any specification
+    // runs, and the rest is started in the order of priority. Each thread
+    // measures its own counters. The first exception other than a failed
+    // assertion stops the run and is rethrown.
+    void runScheduled(ISpecificationVisitorFactory& specificationVisitorFactory, ISpecificationObserver& so, Timestamp deadline)
+    {
+        std::vector<ScheduledSpecification> scheduled;
+        forEachSpecification([&](const Specification& spec)
+        {
+            std::uint64_t cacheKey = 0;
+            if (!selects(spec) || reportedCached(spec, so, cacheKey))
+                return;
+            AllocationCountingPause pause;
+            const ScheduledSpecification next = { spec, cacheKey, priority ? priority(spec.description, spec.location) : 0.0 };
+            scheduled.push_back(next);
+        });
+        std::vector<char> started(scheduled.size(), false);
+        std::atomic<std::size_t> next(0);
+        std::mutex failing;
+        std::exception_ptr error;
+        auto work = [&]
+        {
+            std::unique_ptr<IPerformanceCounterGroup> counters;
+            if (counterFactory)
+            {
+                AllocationCountingPause pause;
+                counters = counterFactory();
+            }
+            try
+            {
+                for (std::size_t index; (index = next++) < scheduled.size(); )
                 {
-                    specificationVisitor->caughtException();
-                    so->testFailed(af);
+                    if (budgeted && TimingClock::now() >= deadline)
+                        break;
+                    started[index] = true;
+                    runAndFinishUncached(scheduled[index].spec, scheduled[index].cacheKey, specificationVisitorFactory, so, counters.get());
                 }
             }
-            while (!specificationVisitor->done());
+            catch (...)
+            {
+                AllocationCountingPause pause;
+                std::lock_guard<std::mutex> lock(failing);
+                if (!error)
+                    error = std::current_exception();
+                next = scheduled.size();
+            }
+        };
+        std::vector<std::thread> threads;
+        {
+            AllocationCountingPause pause;
+            std::stable_sort(scheduled.begin(), scheduled.end(), [](const ScheduledSpecification& left, const ScheduledSpecification& right)
+            {
+                return left.priority > right.priority;
+            });
+            for (unsigned thread = 1; thread < (parallel() ? jobs : 1); ++thread)
+                threads.push_back(std::thread(work));
         }
+        work();
+        AllocationCountingPause pause;
+        for (std::thread& thread : threads)
+            thread.join();
+        if (error)
+            std::rethrow_exception(error);
+        for (std::size_t index = 0; index != scheduled.size(); ++index)
+            if (!started[index])
+            {
+                so.testingSpecificationAt(scheduled[index].spec.description, scheduled[index].spec.location);
+                so.specificationSkipped();
+                so.finishedSpecification();
+            }
+    }
+
+    // A leaf is run regardless of the selection and the cache, and its
+    // coverage is not recorded, as it is only a part of the specification.
+    void runAndFinishLeaf(
+        const Specification& spec, const std::vector<std::string>& path, ISpecificationVisitorFactory& specificationVisitorFactory,
+        ISpecificationObserver& so, const IPerformanceCounterGroup *counters)
+    {
+        LeakDetector leakDetector;
+        runSpecification(spec, specificationVisitorFactory, so, counters, &path);
+        if (leakDetection && AllocationCounter::isEnabled() && leakDetector.leaked())
+        {
+            AllocationCountingPause pause;
+            so.testFailed(leakDetector.failure(spec.description, spec.location));
+        }
+        AllocationCountingPause pause;
+        so.finishedSpecification();
+    }
+
+    bool selects(const Specification& spec) const
+    {
+        return (!tagSelection || tagQuery.matches(spec.tags)) &&
+            (!descriptionSelecting || selectedDescriptions.count(spec.description) != 0) &&
+            (!fileSelection || fileSelection(spec.description, spec.location)) &&
+            (!coverageImpact || coverageImpact(spec.description, spec.location));
+    }
+
+    // Reports a specification which passed before as cached. Otherwise
+    // gives the key to store its pass under.
+    bool reportedCached(const Specification& spec, ISpecificationObserver& so, std::uint64_t& cacheKey)
+    {
+        if (!resultCache)
+            return false;
+        AllocationCountingPause pause;
+        cacheKey = resultCache->key(spec.function, spec.description, cacheOptions);
+        if (!resultCache->contains(cacheKey))
+            return false;
+        so.testingSpecificationAt(spec.description, spec.location);
+        so.specificationCached();
+        so.finishedSpecification();
+        return true;
+    }
+
+    // Leaks are measured for the whole process, so they are only
+    // attributed to a specification when no other runs with it. Coverage
+    // is recorded into one trace, a specification at a time.
+    bool parallel() const
+    {
+        return jobs > 1 && !coverage;
+    }
+
+    void runAndFinishSpecification(
+        const Specification& spec, ISpecificationVisitorFactory& specificationVisitorFactory, ISpecificationObserver& so,
+        const IPerformanceCounterGroup *counters)
+    {
+        std::uint64_t cacheKey = 0;
+        if (selects(spec) && !reportedCached(spec, so, cacheKey))
+            runAndFinishUncached(spec, cacheKey, specificationVisitorFactory, so, counters);
+    }
+
+    void runAndFinishUncached(
+        const Specification& spec, std::uint64_t cacheKey, ISpecificationVisitorFactory& specificationVisitorFactory,
+        ISpecificationObserver& so, const IPerformanceCounterGroup *counters)
+    {
+        LeakDetector leakDetector;
+        if (coverage)
+            coverage->begin();
+        bool passed = runSpecification(spec, specificationVisitorFactory, so, counters);
+        if (coverage)
+        {
+            AllocationCountingPause pause;
+            coverage->end(spec.description);
+        }
+        if (leakDetection && !parallel() && AllocationCounter::isEnabled() && leakDetector.leaked())
+        {
+            AllocationCountingPause pause;
+            so.testFailed(leakDetector.failure(spec.description, spec.location));
+            passed = false;
+        }
+        AllocationCountingPause pause;
+        if (resultCache && passed)
+            resultCache->store(cacheKey);
+        so.finishedSpecification();
+    }
+
+    bool runSpecification(
+        const Specification& spec, ISpecificationVisitorFactory& specificationVisitorFactory, ISpecificationObserver& so,
+        const IPerformanceCounterGroup *counters, const std::vector<std::string> *path = nullptr)
+    {
+        std::shared_ptr<ISpecificationVisitor> specificationVisitor;
+        const Timestamp started = TimingClock::now();
+        unsigned passes = 0;
+        bool passed = true;
+        PerformanceCounters specificationCounters;
+        {
+            AllocationCountingPause pause;
+            so.testingSpecificationAt(spec.description, spec.location);
+            specificationVisitor = specificationVisitorFactory();
+            if (tagSelection)
+                specificationVisitor->selectTags(tagQuery);
+            if (path)
+            {
+                specificationVisitor->selectPath(*path);
+                so.specificationNarrowedToLeaf();
+            }
+        }
+        do {
+            const Timestamp passStarted = TimingClock::now();
+            ++passes;
+            AllocationStatistics before = AllocationCounter::current();
+            const PerformanceCounters countersBefore = counters ? counters->read() : PerformanceCounters();
+            try
+            {
+                spec.function(*specificationVisitor);
+            }
+            catch (const AssertionFailed& af)
+            {
+                AllocationCountingPause pause;
+                specificationVisitor->caughtException();
+                so.testFailed(af);
+                passed = false;
+            }
+            const PerformanceCounters countersAfter = counters ? counters->read() : PerformanceCounters();
+            AllocationStatistics allocated = AllocationCounter::current() - before;
+            const Timestamp passFinished = TimingClock::now();
+            AllocationCountingPause pause;
+            if (AllocationCounter::isEnabled())
+                so.allocationsMeasured(allocated);
+            if (counters)
+            {
+                const PerformanceCounters passCounters = countersAfter - countersBefore;
+                specificationCounters += passCounters;
+                so.leafCountersMeasured(passCounters);
+            }
+            so.leafTimed(passStarted, passFinished);
+        }
+        while (!specificationVisitor->done());
+        AllocationCountingPause pause;
+        if (counters)
+            so.specificationCountersMeasured(specificationCounters);
+        so.specificationTimed(started, TimingClock::now(), passes);
+        return passed;
     }
-private:
-    std::vector<std::pair<std::string, SpecificationFunction>> specs;
 };
 
 
@@ -0,0 +1,428 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_STRINGDIFF_HPP
+#define CXXSPEC_STRINGDIFF_HPP
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+namespace CxxSpec {
+
+namespace Detail
+{
+
+struct Edit
+{
+    enum Operation { Equal, Delete, Insert };
+
+    Operation operation;
+    std::size_t length;
+};
+
+typedef std::vector<Edit> EditScript;
+
+// Myers' O(ND) difference algorithm in linear space (middle snake bisection).
+// When the work budget runs out the remaining differences are reported
+// as a single replacement, so the worst case stays bounded.
+template <typename Element>
+class SequenceDiff
+{
+public:
+    explicit SequenceDiff(std::size_t budget) : budget(budget) { }
+
+    EditScript diff(const Element *a, const Element *aEnd, const Element *b, const Element *bEnd)
+    {
+        EditScript script;
+        compare(a, aEnd, b, bEnd, script);
+        return script;
+    }
+
+private:
+    std::size_t budget;
+
+    static void append(EditScript& script, Edit::Operation operation, std::size_t length)
+    {
+        if (length == 0)
+            return;
+        if (!script.empty() && script.back().operation == operation)
+            script.back().length += length;
+        else
+            script.push_back({ operation, length });
+    }
+
+    void compare(const Element *a, const Element *aEnd, const Element *b, const Element *bEnd, EditScript& script)
+    {
+        std::size_t prefix = 0, suffix = 0;
+        while (a != aEnd && b != bEnd && *a == *b)
+        {
+            ++a; ++b; ++prefix;
+        }
+        while (a != aEnd && b != bEnd && *(aEnd - 1) == *(bEnd - 1))
+        {
+            --aEnd; --bEnd; ++suffix;
+        }
+
+        append(script, Edit::Equal, prefix);
+        std::ptrdiff_t x, y;
+        if (a != aEnd && b != bEnd && bisect(a, aEnd - a, b, bEnd - b, x, y))
+        {
+            compare(a, a + x, b, b + y, script);
+            compare(a + x, aEnd, b + y, bEnd, script);
+        }
+        else
+        {
+            append(script, Edit::Delete, aEnd - a);
+            append(script, Edit::Insert, bEnd - b);
+        }
+        append(script, Edit::Equal, suffix);
+    }
+
+    bool spend(std::size_t work)
+    {
+        if (budget < work)
+        {
+            budget = 0;
+            return false;
+        }
+        budget -= work;
+        return true;
+    }
+
+    bool bisect(const Element *a, std::ptrdiff_t n, const Element *b, std::ptrdiff_t m, std::ptrdiff_t& splitX, std::ptrdiff_t& splitY)
+    {
+        const std::ptrdiff_t maxD = (n + m + 1) / 2;
+        const std::ptrdiff_t offset = maxD;
+        const std::ptrdiff_t size = 2 * maxD + 2;
+        const std::ptrdiff_t delta = n - m;
+        const bool front = (delta % 2 != 0);
+        if (!spend(size))
+            return false;
+
+        std::vector<std::ptrdiff_t> forward(size, -1), reverse(size, -1);
+        forward[offset + 1] = 0;
+        reverse[offset + 1] = 0;
+        std::ptrdiff_t k1start = 0, k1end = 0, k2start = 0, k2end = 0;
+
+        for (std::ptrdiff_t d = 0; d < maxD; ++d)
+        {
+            for (std::ptrdiff_t k1 = -d + k1start; k1 <= d - k1end; k1 += 2)
+            {
+                const std::ptrdiff_t k1Offset = offset + k1;
+                std::ptrdiff_t x1;
+                if (k1 == -d || (k1 != d && forward[k1Offset - 1] < forward[k1Offset + 1]))
+                    x1 = forward[k1Offset + 1];
+                else
+                    x1 = forward[k1Offset - 1] + 1;
+                std::ptrdiff_t y1 = x1 - k1;
+                const std::ptrdiff_t x1Start = x1;
+                while (x1 < n && y1 < m && a[x1] == b[y1])
+                {
+                    ++x1; ++y1;
+                }
+                if (!spend(1 + x1 - x1Start))
+                    return false;
+                forward[k1Offset] = x1;
+                if (x1 > n)
+                    k1end += 2;
+                else if (y1 > m)
+                    k1start += 2;
+                else if (front)
+                {
+                    const std::ptrdiff_t k2Offset = offset + delta - k1;
+                    if (k2Offset >= 0 && k2Offset < size && reverse[k2Offset] != -1 && x1 >= n - reverse[k2Offset])
+                    {
+                        splitX = x1;
+                        splitY = y1;
+                        return true;
+                    }
+                }
+            }
+
+            for (std::ptrdiff_t k2 = -d + k2start; k2 <= d - k2end; k2 += 2)
+            {
+                const std::ptrdiff_t k2Offset = offset + k2;
+                std::ptrdiff_t x2;
+                if (k2 == -d || (k2 != d && reverse[k2Offset - 1] < reverse[k2Offset + 1]))
+                    x2 = reverse[k2Offset + 1];
+                else
+                    x2 = reverse[k2Offset - 1] + 1;
+                std::ptrdiff_t y2 = x2 - k2;
+                const std::ptrdiff_t x2Start = x2;
+                while (x2 < n && y2 < m && a[n - x2 - 1] == b[m - y2 - 1])
+                {
+                    ++x2; ++y2;
+                }
+                if (!spend(1 + x2 - x2Start))
+                    return false;
+                reverse[k2Offset] = x2;
+                if (x2 > n)
+                    k2end += 2;
+                else if (y2 > m)
+                    k2start += 2;
+                else if (!front)
+                {
+                    const std::ptrdiff_t k1Offset = offset + delta - k2;
+                    if (k1Offset >= 0 && k1Offset < size && forward[k1Offset] != -1)
+                    {
+                        const std::ptrdiff_t x1 = forward[k1Offset];
+                        if (x1 >= n - x2)
+                        {
+                            splitX = x1;
+                            splitY = offset + x1 - k1Offset;
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+
+const std::size_t contextLines = 3;
+const std::size_t maxHunks = 10;
+const std::size_t maxLinesPerChange = 20;
+const std::size_t maxLineWidth = 120;
+const std::size_t excerptContext = 30;
+const std::size_t maxCharacterDiff = 400;
+const std::size_t lineDiffBudget = 50000000;
+const std::size_t characterDiffBudget = 100000;
+
+struct TextLine
+{
+    const char *text;
+    std::size_t length;
+    unsigned long long hash;
+
+    friend bool operator==(const TextLine& left, const TextLine& right)
+    {
+        return left.hash == right.hash && left.length == right.length &&
+            std::memcmp(left.text, right.text, left.length) == 0;
+    }
+};
+
+inline std::vector<TextLine> splitLines(const std::string& text)
+{
+    std::vector<TextLine> lines;
+    const char *begin = text.data(), *end = begin + text.size();
+    for (;;)
+    {
+        const char *eol = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+        const char *lineEnd = eol ? eol : end;
+        unsigned long long hash = 14695981039346656037ull;
+        for (const char *c = begin; c != lineEnd; ++c)
+            hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+        lines.push_back({ begin, std::size_t(lineEnd - begin), hash });
+        if (!eol)
+            return lines;
+        begin = eol + 1;
+    }
+}
+
+}
+
+class StringDiff
+{
+public:
+    static bool isWorthDiffing(const std::string& expected, const std::string& actual)
+    {
+        return expected.size() > Detail::maxLineWidth || actual.size() > Detail::maxLineWidth ||
+            expected.find('\n') != std::string::npos || actual.find('\n') != std::string::npos;
+    }
+
+    StringDiff(const std::string& expected, const std::string& actual)
+        : expected(Detail::splitLines(expected)), actual(Detail::splitLines(actual))
+    {
+        Detail::SequenceDiff<Detail::TextLine> differ(Detail::lineDiffBudget);
+        script = differ.diff(
+            this->expected.data(), this->expected.data() + this->expected.size(),
+            this->actual.data(), this->actual.data() + this->actual.size());
+    }
+
+    std::string str() const
+    {
+        std::vector<Change> changes = collectChanges();
+        std::ostringstream os;
+        os << "--- expected\n+++ actual";
+        std::size_t hunks = 0, first = 0;
+        while (first != changes.size())
+        {
+            std::size_t last = first;
+            while (last + 1 != changes.size() &&
+                changes[last + 1].a - (changes[last].a + changes[last].aLength) <= 2 * Detail::contextLines)
+                ++last;
+            if (hunks++ == Detail::maxHunks)
+            {
+                os << "\n... " << (changes.size() - first) << " more differences";
+                break;
+            }
+            writeHunk(os, changes, first, last);
+            first = last + 1;
+        }
+        return os.str();
+    }
+
+private:
+    struct Change
+    {
+        std::size_t a, aLength, b, bLength;
+    };
+
+    std::vector<Detail::TextLine> expected, actual;
+    Detail::EditScript script;
+
+    std::vector<Change> collectChanges() const
+    {
+        std::vector<Change> changes;
+        std::size_t a = 0, b = 0;
+        for (auto edit : script)
+        {
+            if (edit.operation == Detail::Edit::Equal)
+            {
+                a += edit.length;
+                b += edit.length;
+                continue;
+            }
+            if (changes.empty() || changes.back().a + changes.back().aLength != a ||
+                changes.back().b + changes.back().bLength != b)
+                changes.push_back({ a, 0, b, 0 });
+            if (edit.operation == Detail::Edit::Delete)
+            {
+                changes.back().aLength += edit.length;
+                a += edit.length;
+            }
+            else
+            {
+                changes.back().bLength += edit.length;
+                b += edit.length;
+            }
+        }
+        return changes;
+    }
+
+    void writeHunk(std::ostream& os, const std::vector<Change>& changes, std::size_t first, std::size_t last) const
+    {
+        const Change& begin = changes[first];
+        const Change& end = changes[last];
+        const std::size_t leading = std::min(begin.a, Detail::contextLines);
+        const std::size_t trailing = std::min(expected.size() - (end.a + end.aLength), Detail::contextLines);
+        const std::size_t aStart = begin.a - leading, bStart = begin.b - leading;
+        const std::size_t aCount = end.a + end.aLength + trailing - aStart;
+        const std::size_t bCount = end.b + end.bLength + trailing - bStart;
+        os << "\n@@ -" << (aStart + 1) << "," << aCount << " +" << (bStart + 1) << "," << bCount << " @@";
+
+        std::size_t a = aStart;
+        for (std::size_t i = first; i <= last; ++i)
+        {
+            const Change& change = changes[i];
+            for (; a != change.a; ++a)
+                writeLine(os, ' ', expected[a]);
+            if (change.aLength == change.bLength && change.aLength <= Detail::maxLinesPerChange)
+            {
+                for (std::size_t j = 0; j != change.aLength; ++j)
+                    writeLinePair(os, expected[change.a + j], actual[change.b + j]);
+            }
+            else
+            {
+                writeLines(os, '-', expected, change.a, change.aLength);
+                writeLines(os, '+', actual, change.b, change.bLength);
+            }
+            a = change.a + change.aLength;
+        }
+        for (; a != end.a + end.aLength + trailing; ++a)
+            writeLine(os, ' ', expected[a]);
+    }
+
+    static void writeLines(std::ostream& os, char marker, const std::vector<Detail::TextLine>& lines, std::size_t first, std::size_t count)
+    {
+        for (std::size_t i = 0; i != std::min(count, Detail::maxLinesPerChange); ++i)
+            writeLine(os, marker, lines[first + i]);
+        if (count > Detail::maxLinesPerChange)
+            os << "\n" << marker << "... " << (count - Detail::maxLinesPerChange) << " more lines";
+    }
+
+    static void writeLine(std::ostream& os, char marker, const Detail::TextLine& line)
+    {
+        os << "\n" << marker;
+        os.write(line.text, std::min(line.length, Detail::maxLineWidth));
+        if (line.length > Detail::maxLineWidth)
+            os << "...";
+    }
+
+    static void writeLinePair(std::ostream& os, const Detail::TextLine& expectedLine, const Detail::TextLine& actualLine)
+    {
+        const std::size_t shorter = std::min(expectedLine.length, actualLine.length);
+        std::size_t prefix = 0, suffix = 0;
+        while (prefix != shorter && expectedLine.text[prefix] == actualLine.text[prefix])
+            ++prefix;
+        while (suffix != shorter - prefix &&
+            expectedLine.text[expectedLine.length - suffix - 1] == actualLine.text[actualLine.length - suffix - 1])
+            ++suffix;
+
+        const std::size_t expectedMiddle = expectedLine.length - prefix - suffix;
+        const std::size_t actualMiddle = actualLine.length - prefix - suffix;
+        Detail::SequenceDiff<char> differ(Detail::characterDiffBudget);
+        Detail::EditScript chars = differ.diff(
+            expectedLine.text + prefix, expectedLine.text + prefix + std::min(expectedMiddle, Detail::maxCharacterDiff),
+            actualLine.text + prefix, actualLine.text + prefix + std::min(actualMiddle, Detail::maxCharacterDiff));
+
+        const std::size_t start = prefix > Detail::excerptContext ? prefix - Detail::excerptContext : 0;
+        writeExcerpt(os, '-', expectedLine, start, prefix, expectedMiddle, chars, Detail::Edit::Delete);
+        writeExcerpt(os, '+', actualLine, start, prefix, actualMiddle, chars, Detail::Edit::Insert);
+    }
+
+    static void writeExcerpt(
+        std::ostream& os, char marker, const Detail::TextLine& line, std::size_t start, std::size_t prefix,
+        std::size_t middle, const Detail::EditScript& chars, Detail::Edit::Operation changed)
+    {
+        const std::size_t suffix = std::min(line.length, prefix + middle + Detail::excerptContext);
+        const std::size_t end = std::min(suffix, start + Detail::maxLineWidth);
+        std::string guide(prefix - start, ' ');
+        for (auto edit : chars)
+            if (edit.operation == Detail::Edit::Equal || edit.operation == changed)
+                guide.append(edit.length, edit.operation == changed ? '^' : ' ');
+        guide.resize(prefix - start + middle, '^');
+        guide.resize(end - start, ' ');
+        guide.erase(guide.find_last_not_of(' ') + 1);
+
+        const char *ellipsis = start == 0 ? "" : "...";
+        os << "\n" << marker << ellipsis;
+        os.write(line.text + start, end - start);
+        if (end != line.length)
+            os << "...";
+        if (!guide.empty())
+            os << "\n?" << std::string(std::strlen(ellipsis), ' ') << guide;
+    }
+};
+
+}
+
+#endif // CXXSPEC_STRINGDIFF_HPP
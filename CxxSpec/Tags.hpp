@@ -0,0 +1,250 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_TAGS_HPP
+#define CXXSPEC_TAGS_HPP
+#include <bitset>
+#include <cctype>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CxxSpec {
+
+static const std::size_t maxTags = 64;
+
+typedef std::bitset<maxTags> TagSet;
+
+namespace Detail
+{
+
+// Assigns a bit to each distinct tag name the first time it is seen.
+class TagIndex
+{
+public:
+    std::size_t bit(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = bits.find(name);
+        if (found != bits.end())
+            return found->second;
+        if (bits.size() == maxTags)
+            throw std::length_error("more than 64 distinct tags: " + name);
+        const std::size_t next = bits.size();
+        bits.insert(std::make_pair(name, next));
+        return next;
+    }
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::size_t> bits;
+};
+
+inline TagIndex& tagIndex()
+{
+    static TagIndex index;
+    return index;
+}
+
+inline bool isTagCharacter(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '.' || c == ':';
+}
+
+}
+
+// Tags are listed in one string separated by spaces or commas, e.g.
+// "slow io".
+inline TagSet parseTags(const char *tags)
+{
+    TagSet parsed;
+    if (!tags)
+        return parsed;
+    for (const char *c = tags; *c; )
+    {
+        if (!Detail::isTagCharacter(*c))
+        {
+            ++c;
+            continue;
+        }
+        const char *first = c;
+        while (Detail::isTagCharacter(*c))
+            ++c;
+        parsed.set(Detail::tagIndex().bit(std::string(first, c)));
+    }
+    return parsed;
+}
+
+// A boolean expression over tags, such as "smoke & !io" or
+// "(slow | io) & !flaky", compiled to a disjunction of terms. A set of tags
+// matches a term when it has all the required tags and none of the
+// forbidden ones, so evaluating the query is a few bitset operations per
+// term. The empty query matches everything.
+class TagQuery
+{
+public:
+    TagQuery() : terms(1), position(0) { }
+
+    explicit TagQuery(const std::string& query) : text(query), position(0)
+    {
+        skipSpaces();
+        if (position == text.size())
+        {
+            terms.resize(1);
+            return;
+        }
+        terms = parseOr();
+        if (position != text.size())
+            fail("unexpected character");
+    }
+
+    bool matches(const TagSet& tags) const
+    {
+        for (const Term& term : terms)
+            if ((tags & term.required) == term.required && (tags & term.forbidden).none())
+                return true;
+        return false;
+    }
+
+private:
+    struct Term
+    {
+        TagSet required, forbidden;
+    };
+
+    typedef std::vector<Term> Terms;
+
+    Terms terms;
+    std::string text;
+    std::size_t position;
+
+    void fail(const char *message) const
+    {
+        throw std::invalid_argument(std::string("invalid tag query \"") + text + "\": " + message + " at " + std::to_string(position));
+    }
+
+    void skipSpaces()
+    {
+        while (position != text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+            ++position;
+    }
+
+    bool accept(char c)
+    {
+        if (position == text.size() || text[position] != c)
+            return false;
+        ++position;
+        skipSpaces();
+        return true;
+    }
+
+    Terms parseOr()
+    {
+        Terms result = parseAnd();
+        while (accept('|'))
+        {
+            const Terms alternative = parseAnd();
+            result.insert(result.end(), alternative.begin(), alternative.end());
+        }
+        return result;
+    }
+
+    Terms parseAnd()
+    {
+        Terms result = parseNot();
+        while (accept('&'))
+            result = conjunction(result, parseNot());
+        return result;
+    }
+
+    Terms parseNot()
+    {
+        if (accept('!'))
+            return negation(parseNot());
+        if (accept('('))
+        {
+            Terms result = parseOr();
+            if (!accept(')'))
+                fail("expected ')'");
+            return result;
+        }
+        const std::size_t first = position;
+        while (position != text.size() && Detail::isTagCharacter(text[position]))
+            ++position;
+        if (position == first)
+            fail("expected a tag");
+        Term term;
+        term.required.set(Detail::tagIndex().bit(text.substr(first, position - first)));
+        skipSpaces();
+        return Terms(1, term);
+    }
+
+    static Terms conjunction(const Terms& left, const Terms& right)
+    {
+        Terms result;
+        for (const Term& l : left)
+            for (const Term& r : right)
+            {
+                Term term = { l.required | r.required, l.forbidden | r.forbidden };
+                if ((term.required & term.forbidden).none())
+                    result.push_back(term);
+            }
+        return result;
+    }
+
+    static Terms negation(const Terms& terms)
+    {
+        Terms result(1);
+        for (const Term& term : terms)
+        {
+            Terms negated;
+            for (std::size_t bit = 0; bit != maxTags; ++bit)
+            {
+                if (term.required[bit])
+                {
+                    Term literal;
+                    literal.forbidden.set(bit);
+                    negated.push_back(literal);
+                }
+                if (term.forbidden[bit])
+                {
+                    Term literal;
+                    literal.required.set(bit);
+                    negated.push_back(literal);
+                }
+            }
+            result = conjunction(result, negated);
+        }
+        return result;
+    }
+};
+
+}
+
+#endif // CXXSPEC_TAGS_HPP
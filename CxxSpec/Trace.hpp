@@ -0,0 +1,92 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CXXSPEC_TRACE_HPP
+#define CXXSPEC_TRACE_HPP
+#include <CxxSpec/Specification.hpp>
+#include <CxxSpec/Timing.hpp>
+#include <atomic>
+
+#ifdef CXXSPEC_DISABLE_TRACING
+#define CXXSPEC_TRACE_SPAN(name) static_cast<void>(0)
+#else
+#define CXXSPEC_TRACE_SPAN(name) ::CxxSpec::TraceSpan CXXSPEC_CAT(CxxSpec_traceSpan_at_line_, __LINE__)(name)
+#endif
+
+namespace CxxSpec {
+
+class ITraceSpanSink
+{
+public:
+    virtual ~ITraceSpanSink() { }
+    virtual void traceSpan(const char *name, Timestamp start, Timestamp end) = 0;
+};
+
+namespace Detail
+{
+
+inline std::atomic<ITraceSpanSink *>& traceSpanSink()
+{
+    static std::atomic<ITraceSpanSink *> sink(nullptr);
+    return sink;
+}
+
+}
+
+// Times the enclosing scope and reports it to the installed sink. Without
+// a sink a span costs a single atomic load.
+class TraceSpan
+{
+public:
+    TraceSpan(const TraceSpan& ) = delete;
+    TraceSpan& operator=(const TraceSpan& ) = delete;
+
+    explicit TraceSpan(const char *name)
+        : name(name), traced(Detail::traceSpanSink().load(std::memory_order_acquire) != nullptr)
+    {
+        if (traced)
+            start = TimingClock::now();
+    }
+
+    ~TraceSpan()
+    {
+        if (!traced)
+            return;
+        const Timestamp end = TimingClock::now();
+        if (ITraceSpanSink *sink = Detail::traceSpanSink().load(std::memory_order_acquire))
+            sink->traceSpan(name, start, end);
+    }
+
+private:
+    const char *name;
+    bool traced;
+    Timestamp start;
+};
+
+}
+
+#endif // CXXSPEC_TRACE_HPP
@@ -38,6 +38,7 @@ struct SpecificationVisitorMock : CxxSpec::ISpecificationVisitor
     MOCK_METHOD0(endSection, void());
     MOCK_CONST_METHOD0(done, bool());
     MOCK_METHOD0(caughtException, void());
+    MOCK_METHOD1(selectPath, void(const std::vector<std::string>& ));
 };
 
 #endif // SPECIFICATIONVISITORMOCK_HPP
@@ -54,6 +54,8 @@ describe("std::vector<int>")
         {
             expect(v[0]).should == 3;
             expect(v[1]).should == 7;
+            expect(v[0]).should < v[1];
+            expect(v).should.match(CxxSpec::contains(7) && !CxxSpec::contains(5));
         }
         it("should shrink when poping elements")
         {
@@ -35,7 +35,7 @@ public:
     Printable() { }
 };
 
-std::ostream& operator<<(std::ostream& os, const Printable& )
+inline std::ostream& operator<<(std::ostream& os, const Printable& )
 {
     return os << "Printable";
 }
@@ -53,4 +53,22 @@ private:
     int value;
 };
 
+class MoveOnly
+{
+    MoveOnly(const MoveOnly& );
+    MoveOnly& operator=(const MoveOnly& );
+public:
+    explicit MoveOnly(int value) : value(value) { }
+    MoveOnly(MoveOnly&& other) : value(other.value) { }
+
+    friend bool operator==(const MoveOnly& left, int right) { return left.value == right; }
+    friend bool operator!=(const MoveOnly& left, int right) { return left.value != right; }
+    friend bool operator<(const MoveOnly& left, int right) { return left.value < right; }
+    friend bool operator<=(const MoveOnly& left, int right) { return left.value <= right; }
+    friend bool operator>(const MoveOnly& left, int right) { return left.value > right; }
+    friend bool operator>=(const MoveOnly& left, int right) { return left.value >= right; }
+private:
+    int value;
+};
+
 #endif // ASSERTIONTESTINGCLASSES_HPP
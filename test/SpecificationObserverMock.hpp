@@ -8,6 +8,17 @@ struct SpecificationObserverMock: CxxSpec::ISpecificationObserver
     MOCK_METHOD1(testingSpecification, void(const std::string& ));
     MOCK_METHOD1(enteredContext, void(const std::string& ));
     MOCK_METHOD0(leftContext, void());
+    MOCK_METHOD1(allocationsMeasured, void(const CxxSpec::AllocationStatistics& ));
+    MOCK_METHOD0(finishedSpecification, void());
+    MOCK_METHOD0(finishedRun, void());
+    MOCK_METHOD4(sectionTimed, void(const std::string& , CxxSpec::Timestamp , CxxSpec::Timestamp , unsigned ));
+    MOCK_METHOD2(leafTimed, void(CxxSpec::Timestamp , CxxSpec::Timestamp ));
+    MOCK_METHOD3(specificationTimed, void(CxxSpec::Timestamp , CxxSpec::Timestamp , unsigned ));
+    MOCK_METHOD1(leafCountersMeasured, void(const CxxSpec::PerformanceCounters& ));
+    MOCK_METHOD1(specificationCountersMeasured, void(const CxxSpec::PerformanceCounters& ));
+    MOCK_METHOD0(specificationCached, void());
+    MOCK_METHOD0(specificationSkipped, void());
+    MOCK_METHOD0(specificationNarrowedToLeaf, void());
 };
 
 #endif // SPECIFICATIONOBSERVERMOCK_HPP
@@ -1,13 +1,17 @@
 #include <iostream>
 #include <CxxSpec/CxxSpec.hpp>
 #include <CxxSpec/ConsoleSpecificationObserver.hpp>
+#include <CxxSpec/MultiplexingSpecificationObserver.hpp>
+#include <CxxSpec/SlowestSpecificationsObserver.hpp>
 #include <gtest/gtest.h>
 
 int main(int argc, char **argv)
 {
-    auto cso = std::make_shared<CxxSpec::ConsoleSpecificationObserver>(std::cerr);
+    auto so = std::make_shared<CxxSpec::MultiplexingSpecificationObserver>();
+    so->add(std::make_shared<CxxSpec::ConsoleSpecificationObserver>(std::cerr));
+    so->add(std::make_shared<CxxSpec::SlowestSpecificationsObserver>(std::cerr, 5));
     CxxSpec::SpecificationRegistry::getInstance().runAll(
-        [&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(cso); }, cso);
+        [&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(so); }, so);
 
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,252 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/AllocationCounting.hpp>
+#include <CxxSpec/SpecificationRegistry.hpp>
+#include <CxxSpec/Assert.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <gmock/gmock.h>
+#include "SpecificationObserverMock.hpp"
+
+using namespace testing;
+
+namespace CxxSpec
+{
+namespace
+{
+
+std::map<std::string, SpecificationFunction> registeredSpec;
+
+void registerSpecification(const std::string& desc, SpecificationFunction func, const SourceLocation& )
+{
+    registeredSpec.insert(std::make_pair(desc, func));
+}
+
+}
+}
+
+namespace
+{
+
+int allocateOnce()
+{
+    std::unique_ptr<int> p(new int(7));
+    return *p;
+}
+
+int allocateTwice()
+{
+    std::vector<int> v(10);
+    return allocateOnce() + v.size();
+}
+
+}
+
+CXXSPEC_DESCRIBE("allocating specification")
+{
+    std::unique_ptr<int> outer(new int(1));
+    CXXSPEC_CONTEXT("a context with a description long enough not to fit in a small string")
+    {
+        std::unique_ptr<int> inner(new int(2));
+    }
+    CXXSPEC_CONTEXT("another context with a description long enough not to fit in a small string")
+    {
+    }
+}
+
+namespace
+{
+int *leakedInSpecification = nullptr;
+}
+
+CXXSPEC_DESCRIBE("leaking specification")
+{
+    leakedInSpecification = new int(3);
+}
+
+CXXSPEC_DESCRIBE("specification freeing on another thread")
+{
+    int *p = new int(3);
+    std::thread([p]{ delete p; }).join();
+}
+
+struct AllocationCounterTest : testing::Test
+{
+    std::shared_ptr<SpecificationObserverMock> observer;
+    CxxSpec::SpecificationRegistry registry;
+
+    AllocationCounterTest() : observer(std::make_shared<NiceMock<SpecificationObserverMock>>()) { }
+
+    ~AllocationCounterTest()
+    {
+        delete leakedInSpecification;
+        leakedInSpecification = nullptr;
+        CxxSpec::AllocationCounter::setSamplingInterval(64);
+    }
+
+    void runAll()
+    {
+        registry.runAll([&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(observer); }, observer);
+    }
+
+    template <typename F>
+    void expectAssertionFailedWithExpectation(F call, const std::string& expectation)
+    {
+        try
+        {
+            call();
+            FAIL() << "expected AssertionFailed";
+        }
+        catch (const CxxSpec::AssertionFailed& af)
+        {
+            EXPECT_EQ(expectation, af.expectation());
+        }
+    }
+};
+
+TEST_F(AllocationCounterTest, shouldBeEnabledByIncludingAllocationCounting)
+{
+    ASSERT_TRUE(CxxSpec::AllocationCounter::isEnabled());
+}
+
+TEST_F(AllocationCounterTest, shouldCountAllocationsAndBytesOfCurrentThread)
+{
+    CxxSpec::AllocationStatistics before = CxxSpec::AllocationCounter::current();
+    std::unique_ptr<char[]> p(new char[100]);
+    CxxSpec::AllocationStatistics allocated = CxxSpec::AllocationCounter::current() - before;
+    ASSERT_EQ(1u, allocated.allocations);
+    ASSERT_EQ(100u, allocated.bytes);
+}
+
+TEST_F(AllocationCounterTest, shouldNotCountAllocationsWhenPaused)
+{
+    CxxSpec::AllocationStatistics before = CxxSpec::AllocationCounter::current();
+    {
+        CxxSpec::AllocationCountingPause pause;
+        std::unique_ptr<int> p(new int(1));
+    }
+    ASSERT_EQ(0u, (CxxSpec::AllocationCounter::current() - before).allocations);
+}
+
+TEST_F(AllocationCounterTest, allocateNothingShouldPassWhenExpressionDoesNotAllocate)
+{
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(1 + 2).should.allocateNothing());
+}
+
+TEST_F(AllocationCounterTest, allocateNothingShouldThrowWhenExpressionAllocates)
+{
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(allocateOnce()).should.allocateNothing(); },
+        "expected to allocate at most 0 times but allocated 1 times (4 bytes)");
+}
+
+TEST_F(AllocationCounterTest, allocateAtMostShouldCompareNumberOfAllocations)
+{
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(allocateTwice()).should.allocateAtMost(2));
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(allocateTwice()).should.allocateAtMost(1); },
+        "expected to allocate at most 1 times but allocated 2 times (44 bytes)");
+}
+
+TEST_F(AllocationCounterTest, failingComparisonShouldNotCountAllocationsOfItsMessage)
+{
+    const std::string actual(100, 'a'), expected(100, 'b');
+    auto expectation = CXXSPEC_EXPECT(actual);
+    CxxSpec::AllocationStatistics before = CxxSpec::AllocationCounter::current();
+    try
+    {
+        expectation.should == expected;
+    }
+    catch (const CxxSpec::AssertionFailed& )
+    {
+    }
+    try
+    {
+        expectation.should.match(CxxSpec::startsWith(expected));
+    }
+    catch (const CxxSpec::AssertionFailed& )
+    {
+    }
+    ASSERT_EQ(0u, (CxxSpec::AllocationCounter::current() - before).allocations);
+}
+
+TEST_F(AllocationCounterTest, registryShouldReportAllocationsOfEachLeafExcludingFramework)
+{
+    registry.registerSpecification("allocations", CxxSpec::registeredSpec["allocating specification"]);
+    {
+        InSequence seq;
+        EXPECT_CALL(*observer, allocationsMeasured(Field(&CxxSpec::AllocationStatistics::allocations, 2u)));
+        EXPECT_CALL(*observer, allocationsMeasured(Field(&CxxSpec::AllocationStatistics::allocations, 1u)));
+    }
+    runAll();
+}
+
+TEST_F(AllocationCounterTest, shouldTrackLiveAllocations)
+{
+    CxxSpec::AllocationStatistics before = CxxSpec::AllocationCounter::live();
+    std::unique_ptr<char[]> p(new char[10]);
+    ASSERT_EQ(1u, (CxxSpec::AllocationCounter::live() - before).allocations);
+    ASSERT_EQ(10u, (CxxSpec::AllocationCounter::live() - before).bytes);
+    p.reset();
+    ASSERT_EQ(0u, (CxxSpec::AllocationCounter::live() - before).allocations);
+}
+
+TEST_F(AllocationCounterTest, registryShouldReportLeakingSpecificationAsFailure)
+{
+    CxxSpec::AllocationCounter::setSamplingInterval(0);
+    registry.registerSpecification("leak", CxxSpec::registeredSpec["leaking specification"]);
+    EXPECT_CALL(*observer, testFailed(AllOf(
+        Property(&CxxSpec::AssertionFailed::expression, "leak"),
+        Property(&CxxSpec::AssertionFailed::expectation, "leaked 1 allocations (4 bytes)"))));
+    runAll();
+}
+
+TEST_F(AllocationCounterTest, registryShouldReportSampledStacksOfLeakedAllocations)
+{
+    CxxSpec::AllocationCounter::setSamplingInterval(1);
+    registry.registerSpecification("leak", CxxSpec::registeredSpec["leaking specification"]);
+    EXPECT_CALL(*observer, testFailed(Property(&CxxSpec::AssertionFailed::expectation,
+        StartsWith("leaked 1 allocations (4 bytes)\nsampled allocation of 4 bytes at:\n    "))));
+    runAll();
+}
+
+TEST_F(AllocationCounterTest, registryShouldNotReportBlocksFreedOnOtherThreads)
+{
+    registry.registerSpecification("no leak", CxxSpec::registeredSpec["specification freeing on another thread"]);
+    EXPECT_CALL(*observer, testFailed(_)).Times(0);
+    runAll();
+}
+
+TEST_F(AllocationCounterTest, registryShouldNotReportLeaksWhenLeakDetectionIsDisabled)
+{
+    registry.detectLeaks(false);
+    registry.registerSpecification("leak", CxxSpec::registeredSpec["leaking specification"]);
+    EXPECT_CALL(*observer, testFailed(_)).Times(0);
+    runAll();
+}
@@ -28,6 +28,8 @@
 #include <CxxSpec/Assert.hpp>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
 #include <gtest/gtest.h>
 #include "AssertionTestingClasses.hpp"
 
@@ -123,6 +125,84 @@ TEST_F(AssertionTest, operatorEqShouldPrintValuesWhenExpressionsArePrintable)
         "expected to equal 8 but equals 4");
 }
 
+TEST_F(AssertionTest, operatorEqShouldCompareWithValuesOfDifferentType)
+{
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(std::string("abc")).should == "abc");
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(std::string("abc")).should == "abd"; },
+        "expected to equal abd but equals abc");
+}
+
+TEST_F(AssertionTest, comparisonsShouldNotCopyMoveOnlyTemporaries)
+{
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(MoveOnly(7)).should == 7);
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(MoveOnly(7)).should != 8);
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(MoveOnly(7)).should < 8);
+}
+
+TEST_F(AssertionTest, comparisonsShouldNotCopyReferencedValues)
+{
+    MoveOnly value(7);
+    const MoveOnly& reference = value;
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(value).should <= 7);
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(reference).should >= 7);
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(reference).should > 6);
+}
+
+TEST_F(AssertionTest, expressionsReferringIntoTemporariesShouldBeEvaluatedByValue)
+{
+    struct Local
+    {
+        static std::vector<int> make() { return std::vector<int>(4, 3); }
+    };
+    int value = 3;
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(Local::make()[0]).should == 3);
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(Local::make().back()).should != 4);
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(std::min(value, 5)).should == 3);
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(std::vector<int>(2, 3)[1]).should >= 3);
+}
+
+TEST_F(AssertionTest, expressionShouldReferToTheEvaluatedObject)
+{
+    int value = 3;
+    auto expectation = CXXSPEC_EXPECT(value);
+    value = 5;
+    ASSERT_NO_THROW(expectation.should == 5);
+}
+
+TEST_F(AssertionTest, operatorNeShouldThrowWhenExpressionsAreEqual)
+{
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(4).should != 4; },
+        "expected not to equal 4");
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(MoveOnly(4)).should != 4; },
+        "failed inequality check");
+}
+
+TEST_F(AssertionTest, relationalOperatorsShouldPrintValuesWhenComparisonFails)
+{
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(8).should < 4; },
+        "expected to be less than 4 but equals 8");
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(8).should <= 4; },
+        "expected to be less than or equal to 4 but equals 8");
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(2).should > 4; },
+        "expected to be greater than 4 but equals 2");
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(2).should >= 4; },
+        "expected to be greater than or equal to 4 but equals 2");
+}
+
+TEST_F(AssertionTest, relationalOperatorsShouldReportFailureOfNonPrintableValues)
+{
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(MoveOnly(8)).should < 4; },
+        "failed comparison check");
+}
+
 namespace
 {
 int throwLogicError()
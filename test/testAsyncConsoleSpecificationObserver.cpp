@@ -0,0 +1,153 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/AsyncConsoleSpecificationObserver.hpp>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+
+namespace
+{
+
+class LockedStringBuffer : public std::streambuf
+{
+public:
+    std::string str()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return text;
+    }
+
+protected:
+    virtual int overflow(int c)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (c != traits_type::eof())
+            text.push_back(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
+
+    virtual std::streamsize xsputn(const char *s, std::streamsize n)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        text.append(s, n);
+        return n;
+    }
+
+private:
+    std::mutex mutex;
+    std::string text;
+};
+
+}
+
+struct AsyncConsoleSpecificationObserverTest : testing::Test
+{
+    LockedStringBuffer buffer;
+    std::ostream stream;
+
+    AsyncConsoleSpecificationObserverTest() : stream(&buffer) { }
+
+    std::unique_ptr<CxxSpec::AsyncConsoleSpecificationObserver> makeObserver(
+        std::chrono::milliseconds interval = std::chrono::milliseconds(60000), std::size_t bufferSize = 1 << 16)
+    {
+        return std::unique_ptr<CxxSpec::AsyncConsoleSpecificationObserver>(
+            new CxxSpec::AsyncConsoleSpecificationObserver(stream, interval, bufferSize));
+    }
+};
+
+TEST_F(AsyncConsoleSpecificationObserverTest, shouldWriteSameOutputAsConsoleObserverWhenDestroyed)
+{
+    std::ostringstream expected;
+    CxxSpec::ConsoleSpecificationObserver console(expected);
+    auto observer = makeObserver();
+    for (CxxSpec::ISpecificationObserver *o : { static_cast<CxxSpec::ISpecificationObserver *>(&console),
+        static_cast<CxxSpec::ISpecificationObserver *>(observer.get()) })
+    {
+        o->testingSpecification("spec");
+        o->enteredContext("a");
+        o->enteredContext("b");
+        o->leftContext();
+        o->leftContext();
+    }
+    observer.reset();
+    ASSERT_EQ(expected.str(), buffer.str());
+}
+
+TEST_F(AsyncConsoleSpecificationObserverTest, shouldReportCachedAndSkippedSpecificationsLikeConsoleObserver)
+{
+    std::ostringstream expected;
+    CxxSpec::ConsoleSpecificationObserver console(expected);
+    auto observer = makeObserver();
+    for (CxxSpec::ISpecificationObserver *o : { static_cast<CxxSpec::ISpecificationObserver *>(&console),
+        static_cast<CxxSpec::ISpecificationObserver *>(observer.get()) })
+    {
+        o->testingSpecification("cached spec");
+        o->specificationCached();
+        o->finishedSpecification();
+        o->testingSpecification("skipped spec");
+        o->specificationSkipped();
+        o->finishedSpecification();
+    }
+    observer.reset();
+    ASSERT_EQ("cached spec\n    cached\nskipped spec\n    skipped\n", buffer.str());
+    ASSERT_EQ(expected.str(), buffer.str());
+}
+
+TEST_F(AsyncConsoleSpecificationObserverTest, shouldFlushOnFailure)
+{
+    auto observer = makeObserver();
+    observer->testingSpecification("spec");
+    observer->testFailed(CxxSpec::AssertionFailed("{file}", 7, "{expression}", "{expectation}"));
+    ASSERT_EQ("spec\n{expression} {expectation}\nAt {file}:7\n", buffer.str());
+}
+
+TEST_F(AsyncConsoleSpecificationObserverTest, shouldFlushPeriodically)
+{
+    auto observer = makeObserver(std::chrono::milliseconds(1));
+    observer->testingSpecification("spec");
+    for (int i = 0; i != 5000 && buffer.str().empty(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ("spec\n", buffer.str());
+}
+
+TEST_F(AsyncConsoleSpecificationObserverTest, shouldWaitForWriterWhenBufferIsFull)
+{
+    std::string expected;
+    auto observer = makeObserver(std::chrono::milliseconds(60000), 16);
+    for (int i = 0; i != 1000; ++i)
+    {
+        std::ostringstream spec;
+        spec << "specification number " << i;
+        observer->testingSpecification(spec.str());
+        expected += spec.str() + "\n";
+    }
+    observer.reset();
+    ASSERT_EQ(expected, buffer.str());
+}
@@ -0,0 +1,195 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/BinaryEventLog.hpp>
+#include <cstring>
+#include <sstream>
+#include <gmock/gmock.h>
+#include "SpecificationObserverMock.hpp"
+
+using namespace testing;
+
+struct BinaryEventLogTest : testing::Test
+{
+    std::ostringstream stream;
+    std::string bytes;
+
+    void writeLog()
+    {
+        CxxSpec::BinaryEventLogObserver observer(stream);
+        observer.testingSpecification("first");
+        observer.enteredContext("context");
+        observer.leftContext();
+        observer.enteredContext("context");
+        observer.testFailed(CxxSpec::AssertionFailed("file", 7, "expression", "expectation"));
+        observer.leftContext();
+        observer.testingSpecification("second");
+        const CxxSpec::AllocationStatistics allocated = { 3, 40 };
+        observer.allocationsMeasured(allocated);
+    }
+
+    std::string log()
+    {
+        writeLog();
+        return stream.str();
+    }
+};
+
+TEST_F(BinaryEventLogTest, shouldReplayEventsInOrder)
+{
+    bytes = log();
+    CxxSpec::BinaryEventLog log(bytes.data(), bytes.size());
+    StrictMock<SpecificationObserverMock> observer;
+    {
+        InSequence seq;
+        EXPECT_CALL(observer, testingSpecification("first"));
+        EXPECT_CALL(observer, enteredContext("context"));
+        EXPECT_CALL(observer, leftContext());
+        EXPECT_CALL(observer, enteredContext("context"));
+        EXPECT_CALL(observer, testFailed(AllOf(
+            Property(&CxxSpec::AssertionFailed::file, "file"),
+            Property(&CxxSpec::AssertionFailed::line, 7),
+            Property(&CxxSpec::AssertionFailed::expression, "expression"),
+            Property(&CxxSpec::AssertionFailed::expectation, "expectation"))));
+        EXPECT_CALL(observer, leftContext());
+        EXPECT_CALL(observer, testingSpecification("second"));
+        EXPECT_CALL(observer, allocationsMeasured(AllOf(
+            Field(&CxxSpec::AllocationStatistics::allocations, 3u),
+            Field(&CxxSpec::AllocationStatistics::bytes, 40u))));
+    }
+    ASSERT_TRUE(log.isIndexed());
+    ASSERT_EQ(2u, log.specificationCount());
+    log.replay(observer);
+}
+
+TEST_F(BinaryEventLogTest, shouldWriteEachStringOnce)
+{
+    {
+        CxxSpec::BinaryEventLogObserver observer(stream);
+        for (int i = 0; i != 100; ++i)
+            observer.enteredContext("a rather long context description");
+    }
+    bytes = stream.str();
+    ASSERT_EQ(bytes.rfind("a rather long context description"), bytes.find("a rather long context description"));
+    ASSERT_LT(bytes.size(), 100 * sizeof(CxxSpec::Detail::RecordHeader) + 200);
+}
+
+TEST_F(BinaryEventLogTest, shouldReplaySelectedSpecifications)
+{
+    bytes = log();
+    CxxSpec::BinaryEventLog log(bytes.data(), bytes.size());
+    StrictMock<SpecificationObserverMock> observer;
+    {
+        InSequence seq;
+        EXPECT_CALL(observer, testingSpecification("second"));
+        EXPECT_CALL(observer, allocationsMeasured(_));
+    }
+    log.replay(observer, 1, 1);
+}
+
+TEST_F(BinaryEventLogTest, shouldRecoverEventsOfLogCutShort)
+{
+    bytes = log();
+    CxxSpec::Detail::EventLogTrailer trailer;
+    std::memcpy(&trailer, bytes.data() + bytes.size() - sizeof(trailer), sizeof(trailer));
+    bytes.resize(trailer.eventsEnd - 5);
+    CxxSpec::BinaryEventLog log(bytes.data(), bytes.size());
+    StrictMock<SpecificationObserverMock> observer;
+    EXPECT_CALL(observer, testingSpecification("second"));
+    ASSERT_FALSE(log.isIndexed());
+    ASSERT_EQ(2u, log.specificationCount());
+    log.replay(observer, 1);
+}
+
+TEST_F(BinaryEventLogTest, shouldStopReplayingAtUnknownRecord)
+{
+    bytes = log();
+    CxxSpec::Detail::EventLogTrailer trailer;
+    std::memcpy(&trailer, bytes.data() + bytes.size() - sizeof(trailer), sizeof(trailer));
+    std::uint64_t first;
+    std::memcpy(&first, bytes.data() + trailer.specificationIndex, sizeof(first));
+    bytes[first + sizeof(CxxSpec::Detail::RecordHeader)] = char(0xff);
+    CxxSpec::BinaryEventLog log(bytes.data(), bytes.size());
+    StrictMock<SpecificationObserverMock> observer;
+    EXPECT_CALL(observer, testingSpecification("first"));
+    log.replay(observer, 0, 1);
+}
+
+TEST_F(BinaryEventLogTest, shouldRejectIndexPointingOutsideTheLog)
+{
+    bytes = log();
+    CxxSpec::Detail::EventLogTrailer trailer;
+    std::memcpy(&trailer, bytes.data() + bytes.size() - sizeof(trailer), sizeof(trailer));
+    const std::uint64_t outside = bytes.size() * 2;
+    std::string strings = bytes, specifications = bytes;
+    std::memcpy(&strings[trailer.stringIndex], &outside, sizeof(outside));
+    std::memcpy(&specifications[trailer.specificationIndex], &outside, sizeof(outside));
+    NiceMock<SpecificationObserverMock> observer;
+    ASSERT_THROW(CxxSpec::BinaryEventLog(strings.data(), strings.size()).replay(observer), std::runtime_error);
+    ASSERT_THROW(CxxSpec::BinaryEventLog(specifications.data(), specifications.size()).replay(observer), std::runtime_error);
+}
+
+TEST_F(BinaryEventLogTest, shouldRejectStringLongerThanTheLog)
+{
+    bytes = log();
+    CxxSpec::Detail::EventLogTrailer trailer;
+    std::memcpy(&trailer, bytes.data() + bytes.size() - sizeof(trailer), sizeof(trailer));
+    std::uint64_t firstString;
+    std::memcpy(&firstString, bytes.data() + trailer.stringIndex, sizeof(firstString));
+    const std::uint32_t length = 0x7fffffff;
+    std::memcpy(&bytes[firstString + 4], &length, sizeof(length));
+    CxxSpec::BinaryEventLog log(bytes.data(), bytes.size());
+    ASSERT_THROW(log.string(0), std::runtime_error);
+}
+
+TEST_F(BinaryEventLogTest, shouldRejectDataThatIsNotLog)
+{
+    const std::string text = "certainly not an event log";
+    ASSERT_THROW(CxxSpec::BinaryEventLog(text.data(), text.size()), std::runtime_error);
+}
+
+TEST_F(BinaryEventLogTest, shouldReplayTimingEvents)
+{
+    const CxxSpec::Timestamp start = CxxSpec::TimingClock::now(), end = start + std::chrono::microseconds(1500);
+    {
+        CxxSpec::BinaryEventLogObserver observer(stream);
+        observer.testingSpecification("spec");
+        observer.sectionTimed("context", start, end, 2);
+        observer.leafTimed(start, end);
+        observer.specificationTimed(start, end, 3);
+    }
+    bytes = stream.str();
+    CxxSpec::BinaryEventLog log(bytes.data(), bytes.size());
+    StrictMock<SpecificationObserverMock> observer;
+    {
+        InSequence seq;
+        EXPECT_CALL(observer, testingSpecification("spec"));
+        EXPECT_CALL(observer, sectionTimed("context", start, end, 2));
+        EXPECT_CALL(observer, leafTimed(start, end));
+        EXPECT_CALL(observer, specificationTimed(start, end, 3));
+    }
+    log.replay(observer);
+}
@@ -0,0 +1,80 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/ChangedFiles.hpp>
+#include <sstream>
+#include <gtest/gtest.h>
+
+struct ChangedFilesTest : testing::Test
+{
+    CxxSpec::ChangedFileSelection selection;
+
+    void havingChanged(const std::vector<std::string>& files)
+    {
+        selection = CxxSpec::ChangedFileSelection(files);
+    }
+
+    void havingDependencies(const std::string& rules)
+    {
+        std::istringstream is(rules);
+        selection.readDependencies(is);
+    }
+};
+
+TEST_F(ChangedFilesTest, shouldSelectChangedFiles)
+{
+    havingChanged({ "/src/a.cpp", "/src/b.hpp" });
+
+    EXPECT_TRUE(selection.selects("/src/a.cpp"));
+    EXPECT_FALSE(selection.selects("/src/c.cpp"));
+}
+
+TEST_F(ChangedFilesTest, shouldSelectSourcesIncludingChangedHeaders)
+{
+    havingChanged({ "/src/b.hpp" });
+    havingDependencies(
+        "a.o: /src/a.cpp /src/b.hpp \\\n"
+        "  /src/c.hpp\n"
+        "/src/b.hpp:\n"
+        "c.o d.o: /src/c.cpp /src/c.hpp\n");
+
+    EXPECT_TRUE(selection.selects("/src/a.cpp"));
+    EXPECT_FALSE(selection.selects("/src/c.cpp"));
+}
+
+TEST_F(ChangedFilesTest, shouldReadEscapedSpacesInDependencies)
+{
+    havingChanged({ "/my src/b.hpp" });
+    havingDependencies("a.o: /my\\ src/a.cpp /my\\ src/b.hpp");
+
+    EXPECT_TRUE(selection.selects("/my src/a.cpp"));
+}
+
+TEST_F(ChangedFilesTest, shouldQuoteArgumentsForShell)
+{
+    EXPECT_EQ("'a b'", CxxSpec::Detail::shellQuoted("a b"));
+    EXPECT_EQ("'it'\\''s'", CxxSpec::Detail::shellQuoted("it's"));
+}
@@ -0,0 +1,106 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/ChromeTraceSpecificationObserver.hpp>
+#include <cstdio>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+
+namespace
+{
+
+void tracedFunction()
+{
+    CXXSPEC_TRACE_SPAN("traced function");
+}
+
+}
+
+struct ChromeTraceSpecificationObserverTest : testing::Test
+{
+    std::ostringstream os;
+    std::unique_ptr<CxxSpec::ChromeTraceSpecificationObserver> observer;
+    CxxSpec::Timestamp start;
+
+    ChromeTraceSpecificationObserverTest() : observer(new CxxSpec::ChromeTraceSpecificationObserver(os)) { }
+
+    std::string trace()
+    {
+        observer.reset();
+        return std::regex_replace(os.str(), std::regex("\"pid\":[0-9]+,\"tid\":[0-9]+"), "\"pid\":P,\"tid\":T");
+    }
+};
+
+TEST_F(ChromeTraceSpecificationObserverTest, shouldWriteCompleteEventsForSpecificationsPassesAndSections)
+{
+    observer->testingSpecification("spec");
+    observer->enteredContext("a");
+    observer->leftContext();
+    observer->sectionTimed("a", start + std::chrono::microseconds(2), start + std::chrono::nanoseconds(3500), 1);
+    observer->leafTimed(start + std::chrono::microseconds(1), start + std::chrono::microseconds(4));
+    observer->specificationTimed(start, start + std::chrono::microseconds(5), 1);
+    ASSERT_EQ(
+        "{\"traceEvents\":[\n"
+        "{\"ph\":\"X\",\"cat\":\"section\",\"name\":\"a\",\"pid\":P,\"tid\":T,\"ts\":2.000,\"dur\":1.500,\"args\":{\"entries\":1}},\n"
+        "{\"ph\":\"X\",\"cat\":\"pass\",\"name\":\"spec / a\",\"pid\":P,\"tid\":T,\"ts\":1.000,\"dur\":3.000},\n"
+        "{\"ph\":\"X\",\"cat\":\"specification\",\"name\":\"spec\",\"pid\":P,\"tid\":T,\"ts\":0.000,\"dur\":5.000,\"args\":{\"passes\":1}}\n"
+        "]}\n", trace());
+}
+
+TEST_F(ChromeTraceSpecificationObserverTest, shouldWriteInstantEventForFailure)
+{
+    observer->testingSpecification("spec");
+    observer->testFailed(CxxSpec::AssertionFailed("file.cpp", 3, "x", "failed"));
+    const std::string text = std::regex_replace(trace(), std::regex("\"ts\":[0-9.]+"), "\"ts\":0");
+    ASSERT_NE(std::string::npos, text.find(
+        "{\"ph\":\"i\",\"cat\":\"failure\",\"name\":\"x\",\"pid\":P,\"tid\":T,\"ts\":0,\"s\":\"t\","
+        "\"args\":{\"expectation\":\"failed\",\"file\":\"file.cpp\",\"line\":3}}"));
+}
+
+TEST_F(ChromeTraceSpecificationObserverTest, shouldStampFailureWithTheTimeItWasRaised)
+{
+    const CxxSpec::AssertionFailed af("file.cpp", 3, "x", "failed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    observer->testingSpecification("spec");
+    observer->testFailed(af);
+    const long long nanoseconds =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(af.raised().time_since_epoch()).count();
+    char ts[48];
+    std::snprintf(ts, sizeof(ts), "\"ts\":%lld.%03lld,", nanoseconds / 1000, nanoseconds % 1000);
+    ASSERT_NE(std::string::npos, trace().find(ts));
+}
+
+TEST_F(ChromeTraceSpecificationObserverTest, shouldRecordTraceSpansWhileObserverExists)
+{
+    tracedFunction();
+    ASSERT_NE(std::string::npos, trace().find("{\"ph\":\"X\",\"cat\":\"span\",\"name\":\"traced function\""));
+    const std::string written = os.str();
+    tracedFunction();
+    ASSERT_EQ(written, os.str());
+}
@@ -0,0 +1,222 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/SpecificationRegistry.hpp>
+#include <CxxSpec/CoverageHooks.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <gmock/gmock.h>
+#include "SpecificationObserverMock.hpp"
+
+using namespace testing;
+
+namespace
+{
+
+const unsigned firstFunctionLine = __LINE__ + 1;
+__attribute__((noinline)) int coveredByFirst(int x)
+{
+    return x + 1;
+}
+
+const unsigned secondFunctionLine = __LINE__ + 1;
+__attribute__((noinline)) int coveredBySecond(int x)
+{
+    return x * 2;
+}
+
+volatile int sink;
+std::atomic<unsigned> otherThreadCalls(0);
+
+}
+
+struct CoverageTest : testing::Test
+{
+    std::string path;
+    CxxSpec::SpecificationRegistry registry;
+    std::shared_ptr<NiceMock<SpecificationObserverMock>> observer;
+
+    CoverageTest()
+        : path("/tmp/cxxspec-coverage-" + std::to_string(::getpid())),
+        observer(std::make_shared<NiceMock<SpecificationObserverMock>>()) { }
+
+    ~CoverageTest()
+    {
+        std::remove(path.c_str());
+    }
+
+    static void first(CxxSpec::ISpecificationVisitor& visitor)
+    {
+        CxxSpec::SpecificationGuard guard(visitor);
+        sink = coveredByFirst(sink);
+    }
+
+    static void second(CxxSpec::ISpecificationVisitor& visitor)
+    {
+        CxxSpec::SpecificationGuard guard(visitor);
+        sink = coveredBySecond(sink);
+    }
+
+    static void waitingForOtherThread(CxxSpec::ISpecificationVisitor& visitor)
+    {
+        CxxSpec::SpecificationGuard guard(visitor);
+        const unsigned start = otherThreadCalls;
+        while (otherThreadCalls < start + 100)
+            std::this_thread::yield();
+    }
+
+    void record()
+    {
+        registry.registerSpecification("first", &first);
+        registry.registerSpecification("second", &second);
+        auto collector = std::make_shared<CxxSpec::CoverageCollector>();
+        registry.collectCoverage(collector);
+        registry.runAll([&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(observer); }, observer);
+        collector->save(path);
+    }
+
+    CxxSpec::CoverageImpact impactOf(const std::string& file, unsigned first, unsigned last)
+    {
+        const CxxSpec::ChangedLines changed = { file, first, last };
+        return CxxSpec::CoverageMap(path).impact(std::vector<CxxSpec::ChangedLines>(1, changed));
+    }
+};
+
+TEST_F(CoverageTest, shouldSelectSpecificationsEnteringChangedFunctions)
+{
+    record();
+
+    const CxxSpec::CoverageImpact impact = impactOf(__FILE__, secondFunctionLine + 2, secondFunctionLine + 2);
+
+    EXPECT_FALSE(impact.selects("first"));
+    EXPECT_TRUE(impact.selects("second"));
+    EXPECT_TRUE(impact.selects("not recorded"));
+    EXPECT_TRUE(impactOf(__FILE__, secondFunctionLine, secondFunctionLine).selects("second"));
+}
+
+TEST_F(CoverageTest, shouldNotAttributeFunctionsRunByOtherThreads)
+{
+    std::atomic<bool> stop(false);
+    std::thread other([&]
+    {
+        while (!stop)
+        {
+            sink = coveredBySecond(sink);
+            ++otherThreadCalls;
+        }
+    });
+    registry.registerSpecification("waiting", &waitingForOtherThread);
+    record();
+    stop = true;
+    other.join();
+
+    const CxxSpec::CoverageImpact impact = impactOf(__FILE__, secondFunctionLine + 2, secondFunctionLine + 2);
+    EXPECT_FALSE(impact.selects("waiting"));
+    EXPECT_TRUE(impact.selects("second"));
+}
+
+TEST_F(CoverageTest, shouldSelectAllSpecificationsOfFileChangedAboveItsFunctions)
+{
+    record();
+
+    const CxxSpec::CoverageImpact impact = impactOf(__FILE__, 1, 1);
+
+    EXPECT_TRUE(impact.selects("first"));
+    EXPECT_TRUE(impact.selects("second"));
+    EXPECT_FALSE(impactOf(__FILE__, firstFunctionLine + 2, firstFunctionLine + 2).selects("second"));
+}
+
+TEST_F(CoverageTest, shouldSelectEverythingForChangedSourceWithoutCoverage)
+{
+    record();
+
+    EXPECT_TRUE(impactOf("/src/unknown.hpp", 1, 1).selects("first"));
+    EXPECT_FALSE(impactOf("/src/README", 1, 1).selects("first"));
+}
+
+TEST_F(CoverageTest, shouldRejectTruncatedOrCorruptMap)
+{
+    record();
+    std::string map;
+    {
+        std::ifstream is(path.c_str(), std::ios::binary);
+        map.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    }
+    auto rewrite = [&](const std::string& content)
+    {
+        std::ofstream(path.c_str(), std::ios::binary | std::ios::trunc) << content;
+    };
+    CxxSpec::Detail::CoverageMapHeader header;
+    std::memcpy(&header, map.data(), sizeof(header));
+
+    rewrite(map.substr(0, map.size() - 1));
+    EXPECT_THROW(CxxSpec::CoverageMap map(path), std::runtime_error);
+
+    std::string counts = map;
+    const std::uint32_t functionCount = 0xffffffff;
+    std::memcpy(&counts[offsetof(CxxSpec::Detail::CoverageMapHeader, functionCount)], &functionCount, sizeof(functionCount));
+    rewrite(counts);
+    EXPECT_THROW(CxxSpec::CoverageMap map(path), std::runtime_error);
+
+    std::string postings = map;
+    std::fill(postings.end() - header.postingsSize, postings.end(), '\xff');
+    rewrite(postings);
+    EXPECT_THROW(impactOf(__FILE__, 1, 1), std::runtime_error);
+
+    std::string indices = map;
+    std::fill(indices.end() - header.postingsSize, indices.end(), '\x7f');
+    rewrite(indices);
+    EXPECT_THROW(impactOf(__FILE__, 1, 1), std::runtime_error);
+}
+
+TEST_F(CoverageTest, shouldReadOldSideOfUnifiedDiffHunks)
+{
+    const std::vector<CxxSpec::ChangedLines> changes = CxxSpec::parseUnifiedDiff({
+        "diff --git a/src/a.cpp b/src/a.cpp",
+        "--- a/src/a.cpp",
+        "+++ b/src/a.cpp",
+        "@@ -10,3 +10,4 @@ int f()",
+        "@@ -20 +21 @@",
+        "@@ -30,0 +31,2 @@",
+        "--- /dev/null",
+        "+++ b/src/new.cpp",
+        "@@ -0,0 +1,5 @@" }, "/repo");
+
+    ASSERT_EQ(3u, changes.size());
+    EXPECT_EQ("/repo/src/a.cpp", changes[0].file);
+    EXPECT_EQ(10u, changes[0].first);
+    EXPECT_EQ(12u, changes[0].last);
+    EXPECT_EQ(20u, changes[1].first);
+    EXPECT_EQ(20u, changes[1].last);
+    EXPECT_EQ(30u, changes[2].first);
+    EXPECT_EQ(31u, changes[2].last);
+}
@@ -0,0 +1,189 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/DurationHistory.hpp>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+struct DurationHistoryTest : testing::Test
+{
+    CxxSpec::DurationRecorder recorder;
+    std::string path;
+
+    DurationHistoryTest() : path("/tmp/cxxspec-durations-" + std::to_string(::getpid())) { }
+
+    ~DurationHistoryTest()
+    {
+        std::remove(path.c_str());
+    }
+
+    static CxxSpec::Timestamp at(int milliseconds)
+    {
+        return CxxSpec::Timestamp(std::chrono::milliseconds(milliseconds));
+    }
+
+    static CxxSpec::DurationHistory::Durations durations(std::uint64_t specification, const std::map<std::string, std::uint64_t>& leaves)
+    {
+        CxxSpec::DurationHistory::Durations durations;
+        durations.specification = specification;
+        durations.leaves = leaves;
+        return durations;
+    }
+};
+
+TEST_F(DurationHistoryTest, shouldRecordDurationsAndOutcomesOfSpecificationsAndLeaves)
+{
+    recorder.testingSpecification("spec");
+    recorder.enteredContext("a");
+    recorder.enteredContext("b");
+    recorder.leftContext();
+    recorder.leftContext();
+    recorder.leafTimed(at(0), at(2));
+    recorder.enteredContext("c");
+    recorder.leftContext();
+    recorder.leafTimed(at(2), at(5));
+    recorder.specificationTimed(at(0), at(6), 2);
+    recorder.testFailed(CxxSpec::AssertionFailed("a.cpp", 1, "leaked"));
+    recorder.finishedSpecification();
+    recorder.testingSpecification("passing");
+    recorder.leafTimed(at(0), at(1));
+    recorder.specificationTimed(at(0), at(1), 1);
+    recorder.finishedSpecification();
+    recorder.testingSpecification("cached");
+    recorder.specificationCached();
+    recorder.finishedSpecification();
+
+    const CxxSpec::DurationHistory::Entries& entries = recorder.recorded().entries();
+    ASSERT_EQ(2u, entries.size());
+    const CxxSpec::DurationHistory::Durations& spec = entries.at("spec");
+    EXPECT_EQ(6000000u, spec.specification);
+    EXPECT_EQ(2000000u, spec.leaves.at("a / b"));
+    EXPECT_EQ(3000000u, spec.leaves.at("c"));
+    EXPECT_EQ(1u, spec.runs);
+    EXPECT_EQ(1u, spec.failures);
+    EXPECT_EQ(0u, entries.at("passing").failures);
+}
+
+TEST_F(DurationHistoryTest, shouldEstimateFromLongerOfSpecificationAndItsLeaves)
+{
+    CxxSpec::DurationHistory history;
+    history.record("whole", durations(10, { { "a", 4 }, { "b", 4 } }));
+    history.record("partly rerun", durations(3, { { "a", 3 }, { "b", 5 } }));
+
+    EXPECT_EQ(10u, history.estimate("whole"));
+    EXPECT_EQ(8u, history.estimate("partly rerun"));
+}
+
+TEST_F(DurationHistoryTest, shouldEstimateSpecificationsWithoutHistoryFromMeanLeafCount)
+{
+    CxxSpec::DurationHistory history;
+    EXPECT_EQ(0u, history.estimate("new"));
+
+    history.record("one leaf", durations(3, { { "", 3 } }));
+    history.record("three leaves", durations(9, { { "a", 2 }, { "b", 3 }, { "c", 4 } }));
+
+    EXPECT_EQ(6u, history.estimate("new"));
+}
+
+TEST_F(DurationHistoryTest, shouldKeepMeansOfLeavesWhenRecordedAgainUpdatedAndLoaded)
+{
+    CxxSpec::DurationHistory history, newer;
+    history.record("one leaf", durations(3, { { "", 30 } }));
+    history.record("one leaf", durations(3, { { "", 3 } }));
+    history.record("three leaves", durations(9, { { "a", 2 }, { "b", 3 }, { "c", 1 } }));
+    newer.record("three leaves", durations(9, { { "c", 4 } }));
+
+    history.update(newer);
+    history.save(path);
+
+    EXPECT_EQ(6u, history.estimate("new"));
+    EXPECT_EQ(6u, CxxSpec::DurationHistory::load(path).estimate("new"));
+}
+
+TEST_F(DurationHistoryTest, shouldKeepLeavesWhichDidNotRunWhenUpdated)
+{
+    CxxSpec::DurationHistory history, newer;
+    history.record("spec", durations(10, { { "a", 4 }, { "b", 6 } }));
+    history.record("other", durations(1, { { "", 1 } }));
+    newer.record("spec", durations(2, { { "a", 2 } }));
+
+    history.update(newer);
+
+    EXPECT_EQ(2u, history.entries().at("spec").specification);
+    EXPECT_EQ(2u, history.entries().at("spec").leaves.at("a"));
+    EXPECT_EQ(6u, history.entries().at("spec").leaves.at("b"));
+    EXPECT_EQ(1u, history.entries().at("other").specification);
+}
+
+TEST_F(DurationHistoryTest, shouldKeepOutcomesOfRecentRuns)
+{
+    CxxSpec::DurationHistory history;
+    for (unsigned run = 0; run != 40; ++run)
+    {
+        CxxSpec::DurationHistory newer;
+        CxxSpec::DurationHistory::Durations outcome = durations(1, { });
+        outcome.failures = run % 2;
+        outcome.runs = 1;
+        newer.record("spec", outcome);
+        history.update(newer);
+    }
+
+    EXPECT_EQ(32u, history.entries().at("spec").runs);
+    EXPECT_EQ(0x55555555u, history.entries().at("spec").failures);
+}
+
+TEST_F(DurationHistoryTest, shouldSaveAndLoadHistory)
+{
+    CxxSpec::DurationHistory history;
+    CxxSpec::DurationHistory::Durations spec = durations(10, { { "a / b", 4 }, { "c", 6 } });
+    spec.failures = 5;
+    spec.runs = 3;
+    history.record("spec", spec);
+    history.record("no leaves", durations(1, { }));
+
+    history.save(path);
+    const CxxSpec::DurationHistory loaded = CxxSpec::DurationHistory::load(path);
+
+    ASSERT_EQ(2u, loaded.entries().size());
+    EXPECT_EQ(10u, loaded.entries().at("spec").specification);
+    EXPECT_EQ(5u, loaded.entries().at("spec").failures);
+    EXPECT_EQ(3u, loaded.entries().at("spec").runs);
+    EXPECT_EQ(history.entries().at("spec").leaves, loaded.entries().at("spec").leaves);
+    EXPECT_TRUE(loaded.entries().at("no leaves").leaves.empty());
+    EXPECT_TRUE(CxxSpec::DurationHistory::load(path + ".missing").entries().empty());
+}
+
+TEST_F(DurationHistoryTest, shouldRejectTruncatedHistory)
+{
+    CxxSpec::DurationHistory history;
+    history.record("spec", durations(10, { { "a", 4 } }));
+    history.save(path);
+    ::truncate(path.c_str(), 20);
+
+    EXPECT_THROW(CxxSpec::DurationHistory::load(path), std::runtime_error);
+}
@@ -70,7 +70,7 @@ std::vector<int> SpecificationExecutorTest::steps;
 namespace
 {
 
-void registerSpecification(const std::string& desc, SpecificationFunction func)
+void registerSpecification(const std::string& desc, SpecificationFunction func, const SourceLocation& , const char * = nullptr)
 {
     SpecificationExecutorTest::registeredSpec.insert({ desc, func });
 }
@@ -380,4 +380,137 @@ TEST_F(SpecificationExecutorTest, shouldNotifyAboutEnteringAndLeavingNestedConse
     havingExecuted("nested consecutive contexts");
 }
 
-}
\ No newline at end of file
+CXXSPEC_DESCRIBE("timed contexts")
+{
+    CXXSPEC_CONTEXT("a")
+    {
+        CXXSPEC_CONTEXT("b");
+        CXXSPEC_CONTEXT("c");
+    }
+    CXXSPEC_CONTEXT("d")
+    {
+        CXXSPEC_CONTEXT("e");
+    }
+}
+
+TEST_F(SpecificationExecutorTest, shouldTimeEnteredSectionsAndCountTheirEntries)
+{
+    executor = std::make_shared<SpecificationExecutor>(observer);
+    InSequence seq;
+
+    EXPECT_CALL(*observer, sectionTimed("b", _, _, 1));
+    EXPECT_CALL(*observer, sectionTimed("a", _, _, 1));
+    havingExecuted("timed contexts");
+
+    EXPECT_CALL(*observer, sectionTimed("c", _, _, 1));
+    EXPECT_CALL(*observer, sectionTimed("a", _, _, 2));
+    havingExecuted("timed contexts");
+
+    EXPECT_CALL(*observer, sectionTimed("e", _, _, 1));
+    EXPECT_CALL(*observer, sectionTimed("d", _, _, 1));
+    havingExecuted("timed contexts");
+    ASSERT_TRUE(executor->done());
+}
+
+CXXSPEC_DESCRIBE_TAGGED("tagged contexts", "smoke")
+{
+    SpecificationExecutorTest::step(1);
+    CXXSPEC_CONTEXT_TAGGED("io", "io")
+    {
+        SpecificationExecutorTest::step(11);
+        CXXSPEC_CONTEXT("");
+        CXXSPEC_CONTEXT("");
+    }
+    CXXSPEC_CONTEXT("untagged")
+    {
+        SpecificationExecutorTest::step(12);
+        CXXSPEC_CONTEXT_TAGGED("slow", "slow")
+        {
+            SpecificationExecutorTest::step(121);
+        }
+    }
+    CXXSPEC_CONTEXT_TAGGED("slow io", "slow io")
+    {
+        SpecificationExecutorTest::step(13);
+    }
+}
+
+TEST_F(SpecificationExecutorTest, shouldEnterAllTaggedSectionsWithoutSelection)
+{
+    havingExecuted("tagged contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 11));
+    havingExecuted("tagged contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 11));
+    havingExecuted("tagged contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 12, 121));
+    havingExecuted("tagged contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 13));
+    ASSERT_TRUE(executor->done());
+}
+
+TEST_F(SpecificationExecutorTest, shouldSkipExcludedSectionsWithoutSpendingPassesOnThem)
+{
+    executor->selectTags(TagQuery("smoke & !io"));
+
+    havingExecuted("tagged contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 12, 121));
+    ASSERT_TRUE(executor->done());
+}
+
+TEST_F(SpecificationExecutorTest, shouldMatchTagsOfEnclosingSpecificationAndSections)
+{
+    executor->selectTags(TagQuery("smoke & slow"));
+
+    havingExecuted("tagged contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 12, 121));
+    ASSERT_FALSE(executor->done());
+
+    havingExecuted("tagged contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 13));
+    ASSERT_TRUE(executor->done());
+}
+
+CXXSPEC_DESCRIBE("named contexts")
+{
+    SpecificationExecutorTest::step(1);
+    CXXSPEC_CONTEXT("a")
+    {
+        SpecificationExecutorTest::step(11);
+        CXXSPEC_CONTEXT("b")
+        {
+            SpecificationExecutorTest::step(111);
+        }
+        CXXSPEC_CONTEXT("c")
+        {
+            SpecificationExecutorTest::step(112);
+        }
+    }
+    CXXSPEC_CONTEXT("d")
+    {
+        SpecificationExecutorTest::step(12);
+    }
+}
+
+TEST_F(SpecificationExecutorTest, shouldGoStraightDownSelectedPath)
+{
+    executor->selectPath({ "a", "c" });
+
+    havingExecuted("named contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 11, 112));
+    ASSERT_TRUE(executor->done());
+}
+
+TEST_F(SpecificationExecutorTest, shouldEnterAllSectionsBelowSelectedPath)
+{
+    executor->selectPath({ "a" });
+
+    havingExecuted("named contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 11, 111));
+    ASSERT_FALSE(executor->done());
+
+    havingExecuted("named contexts");
+    ASSERT_THAT(steps, ElementsAre(1, 11, 112));
+    ASSERT_TRUE(executor->done());
+}
+
+}
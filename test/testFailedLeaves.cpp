@@ -0,0 +1,122 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/FailedLeaves.hpp>
+#include <cstdio>
+#include <unistd.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+
+struct FailedLeavesTest : testing::Test
+{
+    CxxSpec::FailedLeafRecorder recorder;
+    std::string path;
+
+    FailedLeavesTest() : path("/tmp/cxxspec-failures-" + std::to_string(::getpid())) { }
+
+    ~FailedLeavesTest()
+    {
+        std::remove(path.c_str());
+    }
+
+    void fail()
+    {
+        recorder.testFailed(CxxSpec::AssertionFailed("a.cpp", 1, "x"));
+    }
+
+    void finishPass()
+    {
+        recorder.leafTimed(CxxSpec::Timestamp(), CxxSpec::Timestamp());
+    }
+
+    static CxxSpec::RecordedLeaf leaf(const std::string& specification, const std::vector<std::string>& contexts)
+    {
+        const CxxSpec::RecordedLeaf leaf = { specification, contexts };
+        return leaf;
+    }
+};
+
+TEST_F(FailedLeavesTest, shouldRecordContextsOfFailingLeaves)
+{
+    recorder.testingSpecification("spec");
+    recorder.enteredContext("a");
+    recorder.enteredContext("b");
+    recorder.leftContext();
+    recorder.leftContext();
+    fail();
+    fail();
+    finishPass();
+    recorder.enteredContext("c");
+    recorder.leftContext();
+    finishPass();
+    fail();
+
+    EXPECT_THAT(recorder.failed(), ElementsAre(leaf("spec", { "a", "b" }), leaf("spec", { })));
+}
+
+TEST_F(FailedLeavesTest, shouldKeepPreviousFailuresOfSpecificationsWhichDidNotRun)
+{
+    recorder.testingSpecification("spec");
+    recorder.enteredContext("a");
+    recorder.leftContext();
+    fail();
+    finishPass();
+    recorder.testingSpecification("spec");
+    recorder.enteredContext("a");
+    recorder.leftContext();
+    fail();
+    finishPass();
+
+    const CxxSpec::RecordedLeaves previous = { leaf("spec", { "b" }), leaf("other", { "c" }) };
+
+    EXPECT_THAT(recorder.merged(previous), ElementsAre(leaf("other", { "c" }), leaf("spec", { "a" })));
+}
+
+TEST_F(FailedLeavesTest, shouldDropPreviousFailuresOfLeavesWhichRanOnTheirOwn)
+{
+    recorder.testingSpecification("spec");
+    recorder.specificationNarrowedToLeaf();
+    recorder.enteredContext("a");
+    recorder.leftContext();
+    finishPass();
+    recorder.testingSpecification("spec");
+    recorder.specificationSkipped();
+
+    const CxxSpec::RecordedLeaves previous = { leaf("spec", { "a" }), leaf("spec", { "b" }) };
+
+    EXPECT_THAT(recorder.merged(previous), ElementsAre(leaf("spec", { "b" })));
+}
+
+TEST_F(FailedLeavesTest, shouldSaveAndLoadLeaves)
+{
+    const CxxSpec::RecordedLeaves leaves = { leaf("spec\twith\\tab", { "a\nb", "" }), leaf("no contexts", { }) };
+
+    CxxSpec::saveFailedLeaves(path, leaves);
+
+    EXPECT_EQ(leaves, CxxSpec::loadFailedLeaves(path));
+    EXPECT_TRUE(CxxSpec::loadFailedLeaves(path + ".missing").empty());
+}
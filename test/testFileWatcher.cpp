@@ -0,0 +1,83 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/FileWatcher.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+
+struct FileWatcherTest : testing::Test
+{
+    std::string directory;
+    CxxSpec::FileWatcher watcher;
+
+    FileWatcherTest()
+    {
+        char path[] = "/tmp/cxxspec-watch-XXXXXX";
+        directory = CxxSpec::Detail::canonicalPath(::mkdtemp(path));
+    }
+
+    ~FileWatcherTest()
+    {
+        std::system(("rm -rf " + CxxSpec::Detail::shellQuoted(directory)).c_str());
+    }
+
+    void write(const std::string& name)
+    {
+        std::ofstream(directory + "/" + name) << name;
+    }
+
+    std::vector<std::string> changes()
+    {
+        return watcher.waitForChanges(std::chrono::milliseconds(10));
+    }
+};
+
+TEST_F(FileWatcherTest, shouldReportFilesWrittenInWatchedDirectoriesOnce)
+{
+    ::mkdir((directory + "/src").c_str(), 0700);
+    watcher.watchDirectory(directory);
+
+    write("src/a.cpp");
+    write("b.hpp");
+    write("src/a.cpp");
+
+    const std::vector<std::string> expected = { directory + "/b.hpp", directory + "/src/a.cpp" };
+    EXPECT_EQ(expected, changes());
+}
+
+TEST_F(FileWatcherTest, shouldReportReplacedWatchedFileOnly)
+{
+    write("libspecs.so");
+    watcher.watchFile(directory + "/libspecs.so");
+
+    write("other.so");
+    write("libspecs.so.tmp");
+    std::rename((directory + "/libspecs.so.tmp").c_str(), (directory + "/libspecs.so").c_str());
+
+    EXPECT_EQ(std::vector<std::string>(1, directory + "/libspecs.so"), changes());
+}
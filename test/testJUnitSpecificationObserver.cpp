@@ -0,0 +1,189 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/JUnitSpecificationObserver.hpp>
+#include <CxxSpec/SpecificationRegistry.hpp>
+#include <CxxSpec/Assert.hpp>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <gtest/gtest.h>
+
+namespace CxxSpec
+{
+namespace
+{
+
+std::map<std::string, SpecificationFunction> registeredSpec;
+
+void registerSpecification(const std::string& desc, SpecificationFunction func, const SourceLocation& )
+{
+    registeredSpec.insert(std::make_pair(desc, func));
+}
+
+}
+}
+
+namespace
+{
+
+CXXSPEC_DESCRIBE("junit leaves")
+{
+    CXXSPEC_CONTEXT("a")
+    {
+        CXXSPEC_CONTEXT("b")
+        {
+        }
+        CXXSPEC_CONTEXT("c")
+        {
+            CXXSPEC_EXPECT(1).should == 2;
+        }
+    }
+    CXXSPEC_CONTEXT("d")
+    {
+    }
+}
+
+CXXSPEC_DESCRIBE("junit without contexts")
+{
+}
+
+}
+
+struct JUnitSpecificationObserverTest : testing::Test
+{
+    std::ostringstream stream;
+    std::shared_ptr<CxxSpec::JUnitSpecificationObserver> observer;
+
+    JUnitSpecificationObserverTest() : observer(std::make_shared<CxxSpec::JUnitSpecificationObserver>(stream)) { }
+
+    std::string xml()
+    {
+        observer.reset();
+        std::string text = std::regex_replace(stream.str(), std::regex("time=\"[^\"]*\""), "time=\"T\"");
+        return std::regex_replace(text, std::regex("\" +>"), "\">");
+    }
+};
+
+TEST_F(JUnitSpecificationObserverTest, shouldWriteTestcaseForEachLeafPath)
+{
+    CxxSpec::SpecificationRegistry registry;
+    registry.registerSpecification("junit leaves", CxxSpec::registeredSpec["junit leaves"]);
+    registry.registerSpecification("junit without contexts", CxxSpec::registeredSpec["junit without contexts"]);
+    registry.runAll([&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(observer); }, observer);
+    ASSERT_EQ(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<testsuites tests=\"4\" failures=\"1\" time=\"T\">\n"
+        "  <testsuite name=\"junit leaves\">\n"
+        "    <testcase classname=\"junit leaves\" name=\"a / b\" time=\"T\"/>\n"
+        "    <testcase classname=\"junit leaves\" name=\"a / c\" time=\"T\">\n"
+        "      <failure message=\"1 expected to equal 2 but equals 1\" type=\"AssertionFailed\">"
+        "At " __FILE__ ":63</failure>\n"
+        "    </testcase>\n"
+        "    <testcase classname=\"junit leaves\" name=\"d\" time=\"T\"/>\n"
+        "  </testsuite>\n"
+        "  <testsuite name=\"junit without contexts\">\n"
+        "    <testcase classname=\"junit without contexts\" name=\"junit without contexts\" time=\"T\"/>\n"
+        "  </testsuite>\n"
+        "</testsuites>\n", xml());
+}
+
+TEST_F(JUnitSpecificationObserverTest, shouldReportFailureOutsideContextsAsSpecificationTestcase)
+{
+    observer->testingSpecification("spec");
+    observer->testFailed(CxxSpec::AssertionFailed("file", 3, "x", "failed"));
+    ASSERT_NE(std::string::npos, xml().find(
+        "    <testcase classname=\"spec\" name=\"spec\" time=\"T\">\n"
+        "      <failure message=\"x failed\" type=\"AssertionFailed\">At file:3</failure>\n"));
+}
+
+TEST_F(JUnitSpecificationObserverTest, shouldReportFailureAfterTheLastPassAsItsOwnTestcase)
+{
+    observer->testingSpecification("spec");
+    observer->enteredContext("a");
+    observer->leftContext();
+    observer->testFailed(CxxSpec::AssertionFailed("file", 3, "x", "failed"));
+    observer->leafTimed(CxxSpec::Timestamp(), CxxSpec::Timestamp());
+    observer->enteredContext("b");
+    observer->leftContext();
+    observer->leafTimed(CxxSpec::Timestamp(), CxxSpec::Timestamp());
+    observer->specificationTimed(CxxSpec::Timestamp(), CxxSpec::Timestamp(), 2);
+    observer->testFailed(CxxSpec::AssertionFailed("file", 9, "spec", "leaked"));
+    observer->finishedSpecification();
+    ASSERT_EQ(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<testsuites tests=\"3\" failures=\"2\" time=\"T\">\n"
+        "  <testsuite name=\"spec\">\n"
+        "    <testcase classname=\"spec\" name=\"a\" time=\"T\">\n"
+        "      <failure message=\"x failed\" type=\"AssertionFailed\">At file:3</failure>\n"
+        "    </testcase>\n"
+        "    <testcase classname=\"spec\" name=\"b\" time=\"T\"/>\n"
+        "    <testcase classname=\"spec\" name=\"spec\" time=\"T\">\n"
+        "      <failure message=\"spec leaked\" type=\"AssertionFailed\">At file:9</failure>\n"
+        "    </testcase>\n"
+        "  </testsuite>\n"
+        "</testsuites>\n", xml());
+}
+
+TEST_F(JUnitSpecificationObserverTest, shouldEscapeText)
+{
+    observer->testingSpecification("<a & \"b\"\n'c'>\x01");
+    ASSERT_NE(std::string::npos, xml().find("<testsuite name=\"&lt;a &amp; &quot;b&quot;&#10;&apos;c&apos;&gt;?\">"));
+}
+
+namespace
+{
+
+struct UnseekableBuffer : std::streambuf
+{
+    std::string text;
+
+    virtual int overflow(int c)
+    {
+        text.push_back(traits_type::to_char_type(c));
+        return c;
+    }
+};
+
+}
+
+TEST_F(JUnitSpecificationObserverTest, shouldOmitTotalsForUnseekableStream)
+{
+    UnseekableBuffer buffer;
+    std::ostream os(&buffer);
+    {
+        CxxSpec::JUnitSpecificationObserver junit(os);
+        junit.testingSpecification("spec");
+    }
+    ASSERT_EQ(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<testsuites>\n"
+        "  <testsuite name=\"spec\">\n"
+        "    <testcase classname=\"spec\" name=\"spec\" time=\"T\"/>\n"
+        "  </testsuite>\n"
+        "</testsuites>\n", std::regex_replace(buffer.text, std::regex("time=\"[^\"]*\""), "time=\"T\""));
+}
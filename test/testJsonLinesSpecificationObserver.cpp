@@ -0,0 +1,204 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/JsonLinesSpecificationObserver.hpp>
+#include <CxxSpec/MultiplexingSpecificationObserver.hpp>
+#include <cstdio>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+#include <thread>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+struct JsonLinesSpecificationObserverTest : testing::Test
+{
+    std::FILE *file;
+    std::unique_ptr<CxxSpec::JsonLinesSpecificationObserver> observer;
+
+    JsonLinesSpecificationObserverTest()
+        : file(std::tmpfile()), observer(new CxxSpec::JsonLinesSpecificationObserver(fileno(file))) { }
+
+    ~JsonLinesSpecificationObserverTest()
+    {
+        std::fclose(file);
+    }
+
+    std::string lines()
+    {
+        observer.reset();
+        std::string text;
+        std::rewind(file);
+        char chunk[4096];
+        while (std::size_t n = std::fread(chunk, 1, sizeof(chunk), file))
+            text.append(chunk, n);
+        return std::regex_replace(text, std::regex("\"timestamp\":[0-9]+,\"thread\":[0-9]+,"), "");
+    }
+};
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldWriteOneObjectPerEvent)
+{
+    observer->testingSpecification("spec");
+    observer->enteredContext("a");
+    observer->enteredContext("b");
+    observer->leftContext();
+    observer->leftContext();
+    const CxxSpec::AllocationStatistics allocated = { 2, 16 };
+    observer->allocationsMeasured(allocated);
+    ASSERT_EQ(
+        "{\"event\":\"specification\",\"spec\":\"spec\",\"path\":[]}\n"
+        "{\"event\":\"enteredContext\",\"spec\":\"spec\",\"path\":[\"a\"]}\n"
+        "{\"event\":\"enteredContext\",\"spec\":\"spec\",\"path\":[\"a\",\"b\"]}\n"
+        "{\"event\":\"leftContext\",\"spec\":\"spec\",\"path\":[\"a\",\"b\"]}\n"
+        "{\"event\":\"leftContext\",\"spec\":\"spec\",\"path\":[\"a\"]}\n"
+        "{\"event\":\"allocations\",\"spec\":\"spec\",\"path\":[\"a\",\"b\"],\"allocations\":2,\"bytes\":16}\n", lines());
+}
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldReportFailureWithPathOfLastLeaf)
+{
+    observer->testingSpecification("spec");
+    observer->enteredContext("a");
+    observer->leftContext();
+    observer->testFailed(CxxSpec::AssertionFailed("file.cpp", -3, "x", "failed"));
+    const std::string text = lines();
+    ASSERT_EQ(
+        "{\"event\":\"failure\",\"spec\":\"spec\",\"path\":[\"a\"],"
+        "\"file\":\"file.cpp\",\"line\":-3,\"expression\":\"x\",\"expectation\":\"failed\"}\n",
+        text.substr(text.find("{\"event\":\"failure\"")));
+}
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldStampEventsWithTheKernelThreadId)
+{
+    long other = 0;
+    std::thread([&]{ other = CxxSpec::Detail::currentThreadId(); }).join();
+    ASSERT_EQ(::syscall(SYS_gettid), CxxSpec::Detail::currentThreadId());
+    ASSERT_NE(other, CxxSpec::Detail::currentThreadId());
+    observer->leftContext();
+    observer.reset();
+    std::rewind(file);
+    char line[256] = { };
+    ASSERT_TRUE(std::fgets(line, sizeof(line), file));
+    ASSERT_TRUE(std::regex_search(line, std::regex(",\"thread\":" + std::to_string(::syscall(SYS_gettid)) + ",")));
+}
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldStampReplayedEventsWithTheTimeTheyWereRaised)
+{
+    std::shared_ptr<CxxSpec::JsonLinesSpecificationObserver> shared(observer.release());
+    {
+        CxxSpec::MultiplexingSpecificationObserver multiplexer;
+        multiplexer.add(shared);
+        multiplexer.testingSpecification("spec");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        multiplexer.enteredContext("a");
+        multiplexer.leftContext();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        multiplexer.testFailed(CxxSpec::AssertionFailed("file.cpp", 3, "x", "failed"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        multiplexer.finishedSpecification();
+    }
+    shared.reset();
+    std::rewind(file);
+    std::vector<long long> timestamps;
+    char line[512];
+    while (std::fgets(line, sizeof(line), file))
+        timestamps.push_back(std::stoll(std::string(line).substr(std::string("{\"timestamp\":").size())));
+    ASSERT_EQ(4u, timestamps.size());
+    EXPECT_GE(timestamps[1] - timestamps[0], 5000000);
+    EXPECT_LT(timestamps[2] - timestamps[1], 5000000);
+    EXPECT_GE(timestamps[3] - timestamps[2], 5000000);
+}
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldEscapeStrings)
+{
+    observer->testingSpecification("\"q\" \\ \n\t\x01");
+    ASSERT_EQ("{\"event\":\"specification\",\"spec\":\"\\\"q\\\" \\\\ \\n\\t\\u0001\",\"path\":[]}\n", lines());
+}
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldWriteLinesLongerThanBuffer)
+{
+    const std::string spec(CxxSpec::JsonLinesSpecificationObserver::bufferSize * 2 + 5, 'x');
+    observer->testingSpecification(spec);
+    ASSERT_EQ("{\"event\":\"specification\",\"spec\":\"" + spec + "\",\"path\":[]}\n", lines());
+}
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldWriteTimingEvents)
+{
+    const CxxSpec::Timestamp start(std::chrono::nanoseconds(1000)), end(std::chrono::nanoseconds(3000));
+    observer->testingSpecification("spec");
+    observer->enteredContext("a");
+    observer->leftContext();
+    observer->sectionTimed("a", start, end, 2);
+    observer->leafTimed(start, end);
+    observer->specificationTimed(start, end, 4);
+    const std::string text = lines();
+    ASSERT_EQ(
+        "{\"event\":\"sectionTimed\",\"spec\":\"spec\",\"path\":[],\"context\":\"a\",\"start\":1000,\"end\":3000,\"entries\":2}\n"
+        "{\"event\":\"leafTimed\",\"spec\":\"spec\",\"path\":[\"a\"],\"start\":1000,\"end\":3000}\n"
+        "{\"event\":\"specificationTimed\",\"spec\":\"spec\",\"path\":[],\"start\":1000,\"end\":3000,\"passes\":4}\n",
+        text.substr(text.find("{\"event\":\"sectionTimed\"")));
+}
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldWriteCountersOfTheirSource)
+{
+    observer->testingSpecification("spec");
+    observer->enteredContext("a");
+    observer->leftContext();
+    CxxSpec::PerformanceCounters hardware;
+    hardware.source = CxxSpec::PerformanceCounters::Hardware;
+    hardware.instructions = 1;
+    hardware.cycles = 2;
+    hardware.cacheMisses = 3;
+    hardware.branchMisses = 4;
+    hardware.cpuTimeNanoseconds = 5;
+    observer->leafCountersMeasured(hardware);
+    CxxSpec::PerformanceCounters usage;
+    usage.source = CxxSpec::PerformanceCounters::ResourceUsage;
+    usage.cpuTimeNanoseconds = 1000;
+    usage.pageFaults = 2;
+    usage.contextSwitches = 3;
+    usage.voluntaryContextSwitches = 1;
+    usage.involuntaryContextSwitches = 2;
+    observer->specificationCountersMeasured(usage);
+    ASSERT_EQ(
+        "{\"event\":\"specification\",\"spec\":\"spec\",\"path\":[]}\n"
+        "{\"event\":\"enteredContext\",\"spec\":\"spec\",\"path\":[\"a\"]}\n"
+        "{\"event\":\"leftContext\",\"spec\":\"spec\",\"path\":[\"a\"]}\n"
+        "{\"event\":\"leafCounters\",\"spec\":\"spec\",\"path\":[\"a\"],\"source\":\"perf\",\"instructions\":1,"
+        "\"cycles\":2,\"cacheMisses\":3,\"branchMisses\":4,\"cpuTime\":5,\"pageFaults\":0,\"contextSwitches\":0}\n"
+        "{\"event\":\"specificationCounters\",\"spec\":\"spec\",\"path\":[],\"source\":\"rusage\",\"cpuTime\":1000,"
+        "\"pageFaults\":2,\"contextSwitches\":3,\"voluntaryContextSwitches\":1,\"involuntaryContextSwitches\":2}\n", lines());
+}
+
+TEST_F(JsonLinesSpecificationObserverTest, shouldWriteSourceLocationsWhenKnown)
+{
+    observer->testingSpecificationAt("spec", CxxSpec::SourceLocation("spec.cpp", 3));
+    observer->enteredContextAt("a", CxxSpec::SourceLocation("spec.cpp", 5));
+    ASSERT_EQ(
+        "{\"event\":\"specification\",\"spec\":\"spec\",\"path\":[],\"file\":\"spec.cpp\",\"line\":3}\n"
+        "{\"event\":\"enteredContext\",\"spec\":\"spec\",\"path\":[\"a\"],\"file\":\"spec.cpp\",\"line\":5}\n", lines());
+}
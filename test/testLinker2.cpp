@@ -31,7 +31,7 @@ namespace CxxSpec
 {
 namespace
 {
-void registerSpecification(const std::string& desc, SpecificationFunction func) { }
+void registerSpecification(const std::string& desc, SpecificationFunction func, const SourceLocation& ) { }
 }
 }
 
@@ -0,0 +1,163 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/Assert.hpp>
+#include <CxxSpec/Matchers.hpp>
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "AssertionTestingClasses.hpp"
+
+using namespace CxxSpec;
+
+struct MatchersTest : testing::Test
+{
+    template <typename F>
+    void expectAssertionFailedWithExpectation(F call, const std::string& expectation)
+    {
+        try
+        {
+            call();
+            FAIL() << "expected AssertionFailed";
+        }
+        catch (const AssertionFailed& af)
+        {
+            EXPECT_EQ(expectation, af.expectation());
+        }
+    }
+};
+
+TEST_F(MatchersTest, comparisonMatchersShouldMatchValues)
+{
+    ASSERT_TRUE(equalTo(5).matches(5));
+    ASSERT_FALSE(equalTo(5).matches(6));
+    ASSERT_TRUE(lessThan(5).matches(4));
+    ASSERT_FALSE(lessThan(5).matches(5));
+    ASSERT_TRUE(greaterThan(5).matches(6));
+    ASSERT_FALSE(greaterThan(5).matches(5));
+}
+
+TEST_F(MatchersTest, inRangeShouldIncludeBothBounds)
+{
+    ASSERT_TRUE(inRange(1, 3).matches(1));
+    ASSERT_TRUE(inRange(1, 3).matches(3));
+    ASSERT_FALSE(inRange(1, 3).matches(0));
+    ASSERT_FALSE(inRange(1, 3).matches(4));
+}
+
+TEST_F(MatchersTest, containsShouldSearchRangesAndStrings)
+{
+    std::vector<int> v = { 1, 2, 3 };
+    ASSERT_TRUE(contains(2).matches(v));
+    ASSERT_FALSE(contains(4).matches(v));
+    ASSERT_TRUE(contains("ell").matches(std::string("hello")));
+    ASSERT_FALSE(contains("elo").matches(std::string("hello")));
+}
+
+TEST_F(MatchersTest, stringMatchersShouldCheckPrefixesAndSuffixes)
+{
+    ASSERT_TRUE(startsWith("he").matches(std::string("hello")));
+    ASSERT_FALSE(startsWith("hello!").matches(std::string("hello")));
+    ASSERT_TRUE(endsWith("lo").matches(std::string("hello")));
+    ASSERT_FALSE(endsWith("!hello").matches(std::string("hello")));
+}
+
+TEST_F(MatchersTest, stringMatchersShouldAcceptStringsAsAffixes)
+{
+    const std::string prefix = "he", suffix = "lo";
+    ASSERT_TRUE(startsWith(prefix).matches(std::string("hello")));
+    ASSERT_TRUE(endsWith(suffix).matches(std::string("hello")));
+    ASSERT_TRUE(startsWith(std::string("hex").c_str()).matches(std::string("hexagon")));
+    ASSERT_EQ("starting with he", startsWith(prefix).description());
+}
+
+TEST_F(MatchersTest, matchersShouldCompareCStringsByContent)
+{
+    char text[] = "abc";
+    const std::vector<std::string> words = { "abc", "def" };
+    ASSERT_TRUE(equalTo("abc").matches(std::string("abc")));
+    ASSERT_TRUE(equalTo(text).matches("abc"));
+    ASSERT_FALSE(equalTo("abc").matches("abd"));
+    ASSERT_TRUE(lessThan("abd").matches(std::string("abc")));
+    ASSERT_TRUE(inRange("abc", "abd").matches(std::string("abcd")));
+    ASSERT_TRUE(contains("def").matches(words));
+    ASSERT_TRUE(contains("bc").matches(std::string("abcd")));
+    ASSERT_TRUE(contains('c').matches(std::string("abcd")));
+    ASSERT_EQ("equal to abc", equalTo(text).description());
+}
+
+TEST_F(MatchersTest, passingMatchersShouldNotAllocate)
+{
+    const std::string text = "a text much longer than any small string buffer would hold";
+    ASSERT_NO_THROW(CXXSPEC_EXPECT(
+        (startsWith("a text much longer than") && endsWith("small string buffer would hold") &&
+            !contains("another text much longer than any small string buffer") &&
+            anyOf(equalTo("a text"), contains("than any small string"))).matches(text)).should.allocateNothing());
+}
+
+TEST_F(MatchersTest, containerMatchersShouldCheckSize)
+{
+    std::vector<int> v = { 1, 2 };
+    ASSERT_FALSE(isEmpty().matches(v));
+    ASSERT_TRUE(isEmpty().matches(std::vector<int>()));
+    ASSERT_TRUE(hasSize(2).matches(v));
+    ASSERT_FALSE(hasSize(3).matches(v));
+}
+
+TEST_F(MatchersTest, combinationsShouldComposeMatchers)
+{
+    ASSERT_TRUE(allOf(greaterThan(1), lessThan(5), isNot(equalTo(3))).matches(4));
+    ASSERT_FALSE(allOf(greaterThan(1), lessThan(5), isNot(equalTo(3))).matches(3));
+    ASSERT_TRUE(anyOf(equalTo(1), equalTo(2)).matches(2));
+    ASSERT_FALSE(anyOf(equalTo(1), equalTo(2)).matches(3));
+    ASSERT_TRUE((inRange(1, 10) && !equalTo(5)).matches(6));
+    ASSERT_TRUE((equalTo(1) || equalTo(2)).matches(1));
+}
+
+TEST_F(MatchersTest, combinationsShouldBeDescribedAsExpressions)
+{
+    ASSERT_EQ("(in range [1, 10] and not equal to 5)", (inRange(1, 10) && !equalTo(5)).description());
+    ASSERT_EQ("(equal to 1 or (equal to 2 or equal to 3))", anyOf(equalTo(1), equalTo(2), equalTo(3)).description());
+    ASSERT_EQ("equal to an unprintable value", equalTo(OperatorEqOnly(1)).description());
+}
+
+TEST_F(MatchersTest, matchShouldEvaluateExpressionOnce)
+{
+    int evaluations = 0;
+    auto next = [&]{ return ++evaluations; };
+    CXXSPEC_EXPECT(next()).should.match(allOf(greaterThan(0), lessThan(2), isNot(equalTo(3))));
+    ASSERT_EQ(1, evaluations);
+}
+
+TEST_F(MatchersTest, matchShouldThrowWithDescriptionWhenNotMatched)
+{
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(5).should.match(inRange(1, 10) && !equalTo(5)); },
+        "expected to be (in range [1, 10] and not equal to 5) but equals 5");
+    expectAssertionFailedWithExpectation(
+        []{ CXXSPEC_EXPECT(std::vector<int>()).should.match(contains(3)); },
+        "expected to be containing 3");
+}
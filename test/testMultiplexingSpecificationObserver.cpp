@@ -0,0 +1,164 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/MultiplexingSpecificationObserver.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gmock/gmock.h>
+#include "SpecificationObserverMock.hpp"
+
+using namespace testing;
+
+namespace
+{
+
+class RecordingObserver : public CxxSpec::ISpecificationObserver
+{
+public:
+    std::vector<std::string> events;
+    bool overlapped;
+
+    RecordingObserver() : overlapped(false), inside(false) { }
+
+    virtual void testFailed(const CxxSpec::AssertionFailed& af) { record("failed " + af.expression()); }
+    virtual void testingSpecification(const std::string& spec) { record("spec " + spec); }
+    virtual void enteredContext(const std::string& context) { record("enter " + context); }
+    virtual void leftContext() { record("leave"); }
+
+private:
+    std::atomic<bool> inside;
+
+    void record(const std::string& event)
+    {
+        if (inside.exchange(true))
+            overlapped = true;
+        events.push_back(event);
+        std::this_thread::yield();
+        inside = false;
+    }
+};
+
+}
+
+struct MultiplexingSpecificationObserverTest : testing::Test
+{
+    CxxSpec::MultiplexingSpecificationObserver multiplexer;
+    std::shared_ptr<StrictMock<SpecificationObserverMock>> first, second;
+
+    MultiplexingSpecificationObserverTest()
+        : first(std::make_shared<StrictMock<SpecificationObserverMock>>()),
+        second(std::make_shared<StrictMock<SpecificationObserverMock>>())
+    {
+        multiplexer.add(first);
+        multiplexer.add(second);
+    }
+};
+
+TEST_F(MultiplexingSpecificationObserverTest, shouldForwardEventsToAllObserversWhenSpecificationFinishes)
+{
+    multiplexer.testingSpecification("spec");
+    multiplexer.enteredContext("context");
+    multiplexer.leftContext();
+    multiplexer.testFailed(CxxSpec::AssertionFailed("file", 1, "expression", "expectation"));
+    for (auto observer : { first, second })
+    {
+        InSequence seq;
+        EXPECT_CALL(*observer, testingSpecification("spec"));
+        EXPECT_CALL(*observer, enteredContext("context"));
+        EXPECT_CALL(*observer, leftContext());
+        EXPECT_CALL(*observer, testFailed(Property(&CxxSpec::AssertionFailed::expression, "expression")));
+        EXPECT_CALL(*observer, finishedSpecification());
+    }
+    multiplexer.finishedSpecification();
+}
+
+TEST_F(MultiplexingSpecificationObserverTest, shouldForwardRemainingEventsWhenDestroyed)
+{
+    std::unique_ptr<CxxSpec::MultiplexingSpecificationObserver> observer(new CxxSpec::MultiplexingSpecificationObserver);
+    observer->add(first);
+    observer->testingSpecification("spec");
+    EXPECT_CALL(*first, testingSpecification("spec"));
+    observer.reset();
+}
+
+TEST(MultiplexingSpecificationObserverThreadsTest, shouldDeliverSpecificationsFromThreadsWithoutInterleaving)
+{
+    auto recorder = std::make_shared<RecordingObserver>();
+    {
+        CxxSpec::MultiplexingSpecificationObserver multiplexer;
+        multiplexer.add(recorder);
+        std::vector<std::thread> threads;
+        for (int t = 0; t != 4; ++t)
+            threads.push_back(std::thread([&multiplexer, t]
+            {
+                for (int s = 0; s != 50; ++s)
+                {
+                    const std::string spec = std::to_string(t);
+                    multiplexer.testingSpecification(spec);
+                    multiplexer.enteredContext(spec);
+                    multiplexer.enteredContext(spec);
+                    multiplexer.leftContext();
+                    multiplexer.leftContext();
+                    multiplexer.finishedSpecification();
+                }
+            }));
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+    ASSERT_FALSE(recorder->overlapped);
+    ASSERT_EQ(4u * 50 * 5, recorder->events.size());
+    for (std::size_t i = 0; i != recorder->events.size(); i += 5)
+    {
+        const std::string spec = recorder->events[i].substr(5);
+        ASSERT_EQ("spec " + spec, recorder->events[i]);
+        ASSERT_EQ("enter " + spec, recorder->events[i + 1]);
+        ASSERT_EQ("enter " + spec, recorder->events[i + 2]);
+        ASSERT_EQ("leave", recorder->events[i + 3]);
+        ASSERT_EQ("leave", recorder->events[i + 4]);
+    }
+}
+
+TEST_F(MultiplexingSpecificationObserverTest, shouldForwardTimingEventsAndFinishedRun)
+{
+    const CxxSpec::Timestamp start, end = start + std::chrono::milliseconds(5);
+    multiplexer.testingSpecification("spec");
+    multiplexer.sectionTimed("context", start, end, 2);
+    multiplexer.leafTimed(start, end);
+    multiplexer.specificationTimed(start, end, 3);
+    for (auto observer : { first, second })
+    {
+        InSequence seq;
+        EXPECT_CALL(*observer, testingSpecification("spec"));
+        EXPECT_CALL(*observer, sectionTimed("context", start, end, 2));
+        EXPECT_CALL(*observer, leafTimed(start, end));
+        EXPECT_CALL(*observer, specificationTimed(start, end, 3));
+        EXPECT_CALL(*observer, finishedRun());
+    }
+    multiplexer.finishedRun();
+}
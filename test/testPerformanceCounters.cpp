@@ -0,0 +1,98 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/PerformanceCounterGroup.hpp>
+#include <gmock/gmock.h>
+
+using namespace testing;
+
+struct PerformanceCountersTest : testing::Test
+{
+    volatile unsigned sink;
+
+    PerformanceCountersTest() : sink(0) { }
+
+    void burnCpu(const CxxSpec::PerformanceCounterGroup& counters, std::uint64_t nanoseconds)
+    {
+        const CxxSpec::PerformanceCounters start = counters.read();
+        while ((counters.read() - start).cpuTimeNanoseconds < nanoseconds)
+            for (unsigned i = 0; i < 100000; ++i)
+                sink = sink + i;
+    }
+};
+
+TEST_F(PerformanceCountersTest, shouldSubtractAndAccumulateEachCounter)
+{
+    CxxSpec::PerformanceCounters before, after;
+    after.source = CxxSpec::PerformanceCounters::Hardware;
+    after.instructions = 10;
+    after.cycles = 20;
+    after.cpuTimeNanoseconds = 30;
+    before.instructions = 4;
+    before.cycles = 5;
+    before.cpuTimeNanoseconds = 6;
+
+    CxxSpec::PerformanceCounters total;
+    total += after - before;
+    total += after - before;
+
+    EXPECT_EQ(CxxSpec::PerformanceCounters::Hardware, total.source);
+    EXPECT_EQ(12u, total.instructions);
+    EXPECT_EQ(30u, total.cycles);
+    EXPECT_EQ(48u, total.cpuTimeNanoseconds);
+    EXPECT_EQ(0u, total.branchMisses);
+}
+
+TEST_F(PerformanceCountersTest, shouldFallBackToResourceUsage)
+{
+    CxxSpec::PerformanceCounterGroup counters(false);
+    ASSERT_EQ(CxxSpec::PerformanceCounters::ResourceUsage, counters.source());
+    const CxxSpec::PerformanceCounters before = counters.read();
+
+    burnCpu(counters, 20000000);
+    const CxxSpec::PerformanceCounters measured = counters.read() - before;
+
+    EXPECT_EQ(CxxSpec::PerformanceCounters::ResourceUsage, measured.source);
+    EXPECT_GE(measured.cpuTimeNanoseconds, 20000000u);
+    EXPECT_EQ(0u, measured.instructions);
+    EXPECT_EQ(measured.voluntaryContextSwitches + measured.involuntaryContextSwitches, measured.contextSwitches);
+}
+
+TEST_F(PerformanceCountersTest, shouldCountWorkOfCallingThreadWithAvailableSource)
+{
+    CxxSpec::PerformanceCounterGroup counters;
+    const CxxSpec::PerformanceCounters before = counters.read();
+
+    burnCpu(counters, 5000000);
+    const CxxSpec::PerformanceCounters measured = counters.read() - before;
+
+    EXPECT_EQ(counters.source(), measured.source);
+    EXPECT_GE(measured.cpuTimeNanoseconds, 5000000u);
+    if (measured.source == CxxSpec::PerformanceCounters::Hardware)
+    {
+        EXPECT_GT(measured.instructions, 0u);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/RegressionLikelihood.hpp>
+#include <gtest/gtest.h>
+
+struct RegressionLikelihoodTest : testing::Test
+{
+    std::shared_ptr<CxxSpec::DurationHistory> history;
+
+    RegressionLikelihoodTest() : history(std::make_shared<CxxSpec::DurationHistory>()) { }
+
+    void recorded(const std::string& spec, std::uint64_t milliseconds, std::uint32_t failures, unsigned runs)
+    {
+        CxxSpec::DurationHistory::Durations durations;
+        durations.specification = milliseconds * 1000000;
+        durations.failures = failures;
+        durations.runs = runs;
+        history->record(spec, durations);
+    }
+
+    double score(const std::string& spec, const char *file = nullptr, std::shared_ptr<const CxxSpec::ChangedFileSelection> changed = nullptr)
+    {
+        return CxxSpec::RegressionLikelihood(history, changed)(spec, CxxSpec::SourceLocation(file, 1));
+    }
+};
+
+TEST_F(RegressionLikelihoodTest, shouldPreferRecentFailuresOverOlderOnes)
+{
+    recorded("failed last run", 10, 0x1, 8);
+    recorded("failed before", 10, 0x4, 8);
+    recorded("passing", 10, 0x0, 8);
+
+    EXPECT_GT(score("failed last run"), score("failed before"));
+    EXPECT_GT(score("failed before"), score("passing"));
+}
+
+TEST_F(RegressionLikelihoodTest, shouldPreferFlakyAndChangedSpecifications)
+{
+    recorded("flaky", 10, 0x2, 3);
+    recorded("stable", 10, 0x0, 3);
+    recorded("changed", 10, 0x0, 3);
+    auto changed = std::make_shared<CxxSpec::ChangedFileSelection>(std::vector<std::string>(1, "/src/changed.cpp"));
+
+    EXPECT_GT(score("flaky"), score("stable"));
+    EXPECT_GT(score("changed", "/src/changed.cpp", changed), score("changed", "/src/unchanged.cpp", changed));
+    EXPECT_GT(score("new"), score("stable"));
+}
+
+TEST_F(RegressionLikelihoodTest, shouldDivideLikelihoodByExpectedDuration)
+{
+    recorded("cheap", 10, 0x1, 1);
+    recorded("expensive", 1000, 0x1, 1);
+
+    EXPECT_DOUBLE_EQ(score("cheap"), 100 * score("expensive"));
+}
@@ -0,0 +1,124 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/ChangedFiles.hpp>
+#include <CxxSpec/ResultCache.hpp>
+#include <CxxSpec/SpecificationLibrary.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+
+struct ResultCacheTest : testing::Test
+{
+    std::string directory;
+
+    ResultCacheTest()
+    {
+        char path[] = "/tmp/cxxspec-cache-XXXXXX";
+        directory = ::mkdtemp(path);
+    }
+
+    ~ResultCacheTest()
+    {
+        std::system(("rm -rf " + CxxSpec::Detail::shellQuoted(directory)).c_str());
+    }
+
+    static void specification1(CxxSpec::ISpecificationVisitor& ) { }
+    static void specification2(CxxSpec::ISpecificationVisitor& ) { }
+};
+
+TEST_F(ResultCacheTest, shouldKeyByModuleDescriptionAndOptions)
+{
+    CxxSpec::ResultCache cache(directory + "/results");
+    CxxSpec::SpecificationLibrary library(CXXSPEC_EXAMPLE_SUITE);
+
+    const std::uint64_t key = cache.key(&specification1, "spec", "");
+
+    EXPECT_EQ(key, cache.key(&specification2, "spec", ""));
+    EXPECT_NE(key, cache.key(&specification1, "other", ""));
+    EXPECT_NE(key, cache.key(&specification1, "spec", "tags smoke"));
+    EXPECT_NE(key, cache.key(library.specifications().first->function, "spec", ""));
+}
+
+TEST_F(ResultCacheTest, shouldKeyByContentsOfDeclaredInputs)
+{
+    const std::string input = directory + "/input.txt";
+    std::ofstream(input.c_str()) << "1";
+    CxxSpec::ResultCache cache(directory);
+    cache.declareInput(input);
+    const std::uint64_t key = cache.key(&specification1, "spec", "");
+
+    std::ofstream(input.c_str()) << "2";
+    CxxSpec::ResultCache changed(directory);
+    changed.declareInput(input);
+
+    EXPECT_NE(key, changed.key(&specification1, "spec", ""));
+}
+
+TEST_F(ResultCacheTest, shouldKeyByModulesLoadedWhenTheRunStarts)
+{
+    std::ifstream is(CXXSPEC_EXAMPLE_SUITE, std::ios::binary);
+    std::string original((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    const std::string note("\x04\0\0\0\x14\0\0\0\x03\0\0\0GNU\0", 16);
+    std::string rebuilt = original;
+    const std::size_t buildId = rebuilt.find(note);
+    ASSERT_NE(std::string::npos, buildId);
+    rebuilt[buildId + note.size()] ^= 1;
+    const std::string originalPath = directory + "/original.so", rebuiltPath = directory + "/rebuilt.so";
+    std::ofstream(originalPath.c_str(), std::ios::binary) << original;
+    std::ofstream(rebuiltPath.c_str(), std::ios::binary) << rebuilt;
+    CxxSpec::ResultCache cache(directory);
+    std::uint64_t key, rebuiltKey, reloadedKey;
+    {
+        CxxSpec::SpecificationLibrary library(originalPath);
+        cache.forgetModules();
+        key = cache.key(&specification1, "spec", "");
+    }
+    {
+        CxxSpec::SpecificationLibrary library(rebuiltPath);
+        cache.forgetModules();
+        rebuiltKey = cache.key(&specification1, "spec", "");
+    }
+    {
+        CxxSpec::SpecificationLibrary library(originalPath);
+        cache.forgetModules();
+        reloadedKey = cache.key(&specification1, "spec", "");
+    }
+
+    EXPECT_NE(key, rebuiltKey);
+    EXPECT_EQ(key, reloadedKey);
+}
+
+TEST_F(ResultCacheTest, shouldFindStoredEntries)
+{
+    CxxSpec::ResultCache cache(directory);
+    const std::uint64_t key = cache.key(&specification1, "spec", "");
+
+    EXPECT_FALSE(cache.contains(key));
+    cache.store(key);
+    EXPECT_TRUE(CxxSpec::ResultCache(directory).contains(key));
+}
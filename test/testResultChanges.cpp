@@ -0,0 +1,93 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/ResultChanges.hpp>
+#include <sstream>
+#include <gtest/gtest.h>
+
+struct ResultChangesTest : testing::Test
+{
+    CxxSpec::ResultRecorder recorder;
+
+    void fail()
+    {
+        recorder.testFailed(CxxSpec::AssertionFailed("a.cpp", 1, "x"));
+    }
+
+    void finishPass()
+    {
+        recorder.leafTimed(CxxSpec::Timestamp(), CxxSpec::Timestamp());
+    }
+};
+
+TEST_F(ResultChangesTest, shouldRecordFailingLeavesOfEachSpecification)
+{
+    recorder.testingSpecification("spec");
+    recorder.enteredContext("a");
+    recorder.leftContext();
+    fail();
+    fail();
+    finishPass();
+    recorder.enteredContext("b");
+    recorder.leftContext();
+    finishPass();
+    recorder.testingSpecification("passing");
+    finishPass();
+
+    CxxSpec::RunResults expected;
+    expected["spec"].insert("spec / a");
+    expected["passing"];
+    EXPECT_EQ(expected, recorder.results());
+}
+
+TEST_F(ResultChangesTest, shouldCompareSpecificationsOfCurrentRunOnly)
+{
+    CxxSpec::RunResults previous, current;
+    previous["spec"] = { "spec / a", "spec / b" };
+    previous["other"] = { "other / c" };
+    current["spec"] = { "spec / b", "spec / d" };
+
+    const CxxSpec::ResultChanges changes = CxxSpec::compareResults(previous, current);
+
+    EXPECT_EQ(std::vector<std::string>(1, "spec / d"), changes.failing);
+    EXPECT_EQ(std::vector<std::string>(1, "spec / a"), changes.fixed);
+    EXPECT_EQ(std::vector<std::string>(1, "spec / b"), changes.stillFailing);
+}
+
+TEST_F(ResultChangesTest, shouldPrintChanges)
+{
+    CxxSpec::ResultChanges changes;
+    changes.failing.push_back("spec / d");
+    changes.fixed.push_back("spec / a");
+    std::ostringstream os;
+
+    CxxSpec::printResultChanges(os, changes);
+
+    EXPECT_EQ(
+        "newly failing: spec / d\n"
+        "fixed: spec / a\n"
+        "1 newly failing, 1 fixed, 0 still failing\n", os.str());
+}
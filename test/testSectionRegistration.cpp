@@ -0,0 +1,59 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#define CXXSPEC_USE_SECTION_REGISTRATION
+#include <CxxSpec/CxxSpec.hpp>
+#include <cstring>
+#include <gtest/gtest.h>
+
+static_assert(__LINE__ == 32, "descriptor line below");
+CXXSPEC_DESCRIBE("section registered specification")
+{
+    CXXSPEC_CONTEXT("should run from the descriptor")
+    {
+    }
+}
+
+struct SectionRegistrationTest : testing::Test
+{
+    const CxxSpec::SpecificationDescriptor *find(const char *description)
+    {
+        const CxxSpec::SpecificationDescriptors linked = CxxSpec::Detail::linkedSpecifications();
+        for (const CxxSpec::SpecificationDescriptor *descriptor = linked.first; descriptor != linked.last; ++descriptor)
+            if (std::strcmp(descriptor->description, description) == 0)
+                return descriptor;
+        return nullptr;
+    }
+};
+
+TEST_F(SectionRegistrationTest, shouldPlaceDescriptorOfSpecificationInLinkedSection)
+{
+    const CxxSpec::SpecificationDescriptor *descriptor = find("section registered specification");
+    ASSERT_TRUE(descriptor != nullptr);
+    EXPECT_TRUE(descriptor->function != nullptr);
+    EXPECT_STREQ(__FILE__, descriptor->file);
+    EXPECT_EQ(33u, descriptor->line);
+}
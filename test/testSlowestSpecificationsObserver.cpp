@@ -0,0 +1,89 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/SlowestSpecificationsObserver.hpp>
+#include <sstream>
+#include <gtest/gtest.h>
+
+struct SlowestSpecificationsObserverTest : testing::Test
+{
+    std::ostringstream os;
+    CxxSpec::Timestamp start;
+
+    void runSpecification(CxxSpec::ISpecificationObserver& observer, const std::string& spec, int leafMilliseconds, int leaves)
+    {
+        observer.testingSpecification(spec);
+        for (int i = 0; i != leaves; ++i)
+        {
+            observer.enteredContext("leaf " + std::to_string(i));
+            observer.leftContext();
+            observer.leafTimed(start, start + std::chrono::milliseconds(leafMilliseconds * (i + 1)));
+        }
+        observer.specificationTimed(start, start + std::chrono::milliseconds(leafMilliseconds * leaves), leaves);
+    }
+};
+
+TEST_F(SlowestSpecificationsObserverTest, shouldPrintSlowestSpecificationsAndLeavesWhenRunFinishes)
+{
+    CxxSpec::SlowestSpecificationsObserver observer(os, 2);
+    runSpecification(observer, "fast", 1, 1);
+    runSpecification(observer, "slow", 10, 2);
+    runSpecification(observer, "medium", 5, 1);
+    ASSERT_EQ("", os.str());
+    observer.finishedRun();
+    ASSERT_EQ(
+        "Slowest specifications:\n"
+        "      20.000 ms  slow (2 passes)\n"
+        "       5.000 ms  medium (1 pass)\n"
+        "Slowest leaves:\n"
+        "      20.000 ms  slow / leaf 1\n"
+        "      10.000 ms  slow / leaf 0\n", os.str());
+}
+
+TEST_F(SlowestSpecificationsObserverTest, shouldNameLeafOfPassWithoutContextsAfterSpecification)
+{
+    CxxSpec::SlowestSpecificationsObserver observer(os, 1);
+    runSpecification(observer, "spec", 1, 1);
+    observer.testingSpecification("no contexts");
+    observer.leafTimed(start, start + std::chrono::milliseconds(3));
+    observer.finishedRun();
+    ASSERT_NE(std::string::npos, os.str().find("       3.000 ms  no contexts\n"));
+}
+
+TEST_F(SlowestSpecificationsObserverTest, shouldPrintNothingWhenNoSpecificationsRan)
+{
+    CxxSpec::SlowestSpecificationsObserver observer(os);
+    observer.finishedRun();
+    ASSERT_EQ("", os.str());
+}
+
+TEST_F(SlowestSpecificationsObserverTest, shouldKeepNothingWhenCountIsZero)
+{
+    CxxSpec::SlowestSpecificationsObserver observer(os, 0);
+    runSpecification(observer, "spec", 1, 2);
+    observer.finishedRun();
+    ASSERT_EQ("", os.str());
+}
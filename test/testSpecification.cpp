@@ -45,7 +45,7 @@ namespace
 
 std::map<std::string, SpecificationFunction> registeredSpec;
 
-void registerSpecification(const std::string& desc, SpecificationFunction func)
+void registerSpecification(const std::string& desc, SpecificationFunction func, const SourceLocation& )
 {
     registeredSpec.insert(std::make_pair(desc, func));
 }
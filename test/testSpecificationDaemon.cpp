@@ -0,0 +1,177 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/SpecificationDaemon.hpp>
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+struct SpecificationDaemonTest : testing::Test
+{
+    std::string path;
+    CxxSpec::SpecificationRegistry registry;
+    std::unique_ptr<CxxSpec::SpecificationDaemon> daemon;
+
+    static bool passingCalled;
+
+    static void passing(CxxSpec::ISpecificationVisitor& visitor)
+    {
+        CxxSpec::SpecificationGuard guard(visitor);
+        passingCalled = true;
+    }
+
+    static void failing(CxxSpec::ISpecificationVisitor& visitor)
+    {
+        CxxSpec::SpecificationGuard guard(visitor);
+        throw CxxSpec::AssertionFailed("spec.cpp", 7, "x", "should be 1");
+    }
+
+    static void nested(CxxSpec::ISpecificationVisitor& visitor)
+    {
+        CxxSpec::SpecificationGuard guard(visitor);
+        if (CxxSpec::SectionGuard first = CxxSpec::SectionGuard(visitor, "first"))
+            throw CxxSpec::AssertionFailed("spec.cpp", 11, "y", "should fail in first");
+        if (CxxSpec::SectionGuard second = CxxSpec::SectionGuard(visitor, "second"))
+            throw CxxSpec::AssertionFailed("spec.cpp", 13, "y", "should fail in second");
+    }
+
+    SpecificationDaemonTest() : path("/tmp/cxxspec-daemon-" + std::to_string(::getpid()))
+    {
+        passingCalled = false;
+        registry.registerSpecification("passing", &passing, CxxSpec::SourceLocation(), "smoke");
+        registry.registerSpecification("failing", &failing);
+        registry.registerSpecification("nested", &nested);
+        daemon.reset(new CxxSpec::SpecificationDaemon(path, registry));
+    }
+
+    std::string requestRun(const std::string& request)
+    {
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        const sockaddr_un address = CxxSpec::Detail::socketAddress(path);
+        EXPECT_EQ(0, ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)));
+        EXPECT_EQ(ssize_t(request.size()), ::write(fd, request.data(), request.size()));
+        daemon->acceptRun();
+        std::string response;
+        char buffer[1024];
+        for (ssize_t length; (length = ::read(fd, buffer, sizeof(buffer))) > 0; )
+            response.append(buffer, length);
+        ::close(fd);
+        return response;
+    }
+};
+
+bool SpecificationDaemonTest::passingCalled = false;
+
+TEST_F(SpecificationDaemonTest, shouldParseRequest)
+{
+    const CxxSpec::RunRequest request = CxxSpec::RunRequest::parse(
+        "tags smoke & !io\n"
+        "spec parser\n"
+        "spec parser\tnumbers\\tand signs\tnegative\n"
+        "changed /src/a.cpp\n"
+        "changed /src/b.hpp\n"
+        "reporter jsonlines\n"
+        "counters\n"
+        "\n");
+
+    EXPECT_EQ("smoke & !io", request.tags);
+    EXPECT_EQ(std::vector<std::string>({ "/src/a.cpp", "/src/b.hpp" }), request.changed);
+    ASSERT_EQ(2u, request.specs.size());
+    EXPECT_EQ("parser", request.specs[0].specification);
+    EXPECT_TRUE(request.specs[0].contexts.empty());
+    EXPECT_EQ("parser", request.specs[1].specification);
+    EXPECT_EQ(std::vector<std::string>({ "numbers\tand signs", "negative" }), request.specs[1].contexts);
+    EXPECT_EQ("jsonlines", request.reporter);
+    EXPECT_TRUE(request.counters);
+    EXPECT_THROW(CxxSpec::RunRequest::parse("reporter xml\n\n"), std::invalid_argument);
+}
+
+TEST_F(SpecificationDaemonTest, shouldStreamReportOfRunInForkedChild)
+{
+    const std::string report = requestRun("\n");
+
+    EXPECT_NE(std::string::npos, report.find("passing\n"));
+    EXPECT_NE(std::string::npos, report.find("failing\nx should be 1\nAt spec.cpp:7\n"));
+    EXPECT_FALSE(passingCalled);
+}
+
+TEST_F(SpecificationDaemonTest, shouldApplyFiltersOfEachRequestOnly)
+{
+    const std::string selected = requestRun("tags smoke\nreporter jsonlines\n\n");
+    const std::string all = requestRun("\n");
+
+    EXPECT_NE(std::string::npos, selected.find("\"spec\":\"passing\""));
+    EXPECT_EQ(std::string::npos, selected.find("failing"));
+    EXPECT_NE(std::string::npos, all.find("failing"));
+}
+
+TEST_F(SpecificationDaemonTest, shouldRunRequestedSpecificationsAndLeavesOnly)
+{
+    const std::string whole = requestRun("spec failing\n\n");
+    const std::string leaf = requestRun("spec nested\tsecond\n\n");
+    const std::string both = requestRun("spec passing\nspec nested\tfirst\n\n");
+
+    EXPECT_NE(std::string::npos, whole.find("failing\n"));
+    EXPECT_EQ(std::string::npos, whole.find("passing"));
+    EXPECT_EQ(std::string::npos, whole.find("nested"));
+    EXPECT_NE(std::string::npos, leaf.find("should fail in second"));
+    EXPECT_EQ(std::string::npos, leaf.find("should fail in first"));
+    EXPECT_EQ(std::string::npos, leaf.find("failing"));
+    EXPECT_NE(std::string::npos, both.find("passing\n"));
+    EXPECT_NE(std::string::npos, both.find("should fail in first"));
+    EXPECT_EQ(std::string::npos, both.find("should fail in second"));
+    EXPECT_EQ(std::string::npos, both.find("failing"));
+}
+
+TEST_F(SpecificationDaemonTest, shouldReapFinishedRunsWhileWaitingForConnection)
+{
+    requestRun("\n");
+    siginfo_t info;
+    bool children = true;
+    for (int i = 0; i != 500 && children; ++i)
+    {
+        EXPECT_FALSE(daemon->waitForConnection(std::chrono::milliseconds(10)));
+        children = ::waitid(P_ALL, 0, &info, WEXITED | WNOHANG | WNOWAIT) == 0;
+    }
+    EXPECT_FALSE(children);
+}
+
+TEST_F(SpecificationDaemonTest, shouldLeaveChildrenItDidNotForkToTheirParent)
+{
+    const pid_t other = ::fork();
+    if (other == 0)
+        ::_exit(3);
+    requestRun("\n");
+    for (int i = 0; i != 50; ++i)
+        daemon->waitForConnection(std::chrono::milliseconds(10));
+    int status = 0;
+    ASSERT_EQ(other, ::waitpid(other, &status, 0));
+    EXPECT_EQ(3, WEXITSTATUS(status));
+}
+
+TEST_F(SpecificationDaemonTest, shouldReportInvalidRequest)
+{
+    EXPECT_EQ("cxxspec: invalid request line: filter x\n", requestRun("filter x\n\n"));
+}
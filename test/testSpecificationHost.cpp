@@ -0,0 +1,125 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/SpecificationHost.hpp>
+#include <cstdio>
+#include <gmock/gmock.h>
+#include "SpecificationObserverMock.hpp"
+
+using namespace testing;
+
+struct SpecificationHostTest : testing::Test
+{
+    std::string path;
+    CxxSpec::SpecificationRegistry registry;
+    std::shared_ptr<NiceMock<SpecificationObserverMock>> observer;
+
+    SpecificationHostTest()
+        : path("/tmp/libhosted-" + std::to_string(::getpid()) + ".so"),
+        observer(std::make_shared<NiceMock<SpecificationObserverMock>>())
+    {
+        build(path);
+    }
+
+    ~SpecificationHostTest()
+    {
+        std::remove(path.c_str());
+    }
+
+    void build(const std::string& target)
+    {
+        std::ifstream in(CXXSPEC_EXAMPLE_SUITE, std::ios::binary);
+        std::ofstream(target.c_str(), std::ios::binary) << in.rdbuf();
+    }
+
+    void rebuild()
+    {
+        build(path + ".new");
+        std::rename((path + ".new").c_str(), path.c_str());
+    }
+
+    void run()
+    {
+        registry.runAll([&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(observer); }, observer);
+    }
+};
+
+TEST_F(SpecificationHostTest, shouldRegisterLoadedLibrariesWhileAlive)
+{
+    {
+        CxxSpec::SpecificationHost host(registry);
+        host.load(path);
+
+        EXPECT_CALL(*observer, testingSpecification("hosted-" + std::to_string(::getpid()) + ": int"));
+        EXPECT_CALL(*observer, testingSpecification("hosted-" + std::to_string(::getpid()) + ": std::vector<int>"));
+        run();
+        Mock::VerifyAndClearExpectations(observer.get());
+    }
+
+    EXPECT_CALL(*observer, testingSpecification(_)).Times(0);
+    run();
+}
+
+TEST_F(SpecificationHostTest, shouldReplaceRebuiltLibrary)
+{
+    CxxSpec::SpecificationHost host(registry);
+    host.load(path);
+    EXPECT_TRUE(host.changedLibraries().empty());
+
+    rebuild();
+    ASSERT_EQ(std::vector<std::string>(1, path), host.changedLibraries());
+    host.reload(path);
+
+    EXPECT_TRUE(host.changedLibraries().empty());
+    EXPECT_CALL(*observer, testingSpecification(_)).Times(2);
+    run();
+}
+
+TEST_F(SpecificationHostTest, shouldKeepOldLibraryWhenRebuiltOneCannotBeLoaded)
+{
+    CxxSpec::SpecificationHost host(registry);
+    host.load(path);
+
+    std::ofstream(path.c_str()) << "truncated";
+    EXPECT_THROW(host.reload(path), std::runtime_error);
+
+    EXPECT_CALL(*observer, testingSpecification(_)).Times(2);
+    run();
+}
+
+TEST_F(SpecificationHostTest, shouldLendHostFixturesOfMatchingType)
+{
+    CxxSpec::SpecificationHost host(registry);
+    auto fixture = std::make_shared<int>(7);
+    host.fixtures().provide("answer", fixture);
+
+    EXPECT_THROW(CxxSpec::hostFixture<int>("answer"), std::logic_error);
+    CxxSpec::Detail::attachedHostFixtures() = &host.fixtures();
+    EXPECT_EQ(fixture, CxxSpec::hostFixture<int>("answer"));
+    EXPECT_THROW(CxxSpec::hostFixture<long>("answer"), std::logic_error);
+    EXPECT_THROW(CxxSpec::hostFixture<int>("question"), std::out_of_range);
+    CxxSpec::Detail::attachedHostFixtures() = nullptr;
+}
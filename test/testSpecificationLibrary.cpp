@@ -0,0 +1,76 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/SpecificationLibrary.hpp>
+#include <CxxSpec/SpecificationRegistry.hpp>
+#include <stdexcept>
+#include <gmock/gmock.h>
+#include "SpecificationObserverMock.hpp"
+
+using namespace testing;
+
+struct SpecificationLibraryTest : testing::Test
+{
+};
+
+TEST_F(SpecificationLibraryTest, shouldNameSuiteAfterLibraryFile)
+{
+    EXPECT_EQ("parser", CxxSpec::SpecificationLibrary::suiteName("specs/libparser.so"));
+    EXPECT_EQ("parser", CxxSpec::SpecificationLibrary::suiteName("libparser.so.1"));
+    EXPECT_EQ("parser", CxxSpec::SpecificationLibrary::suiteName("/tmp/parser.so"));
+}
+
+TEST_F(SpecificationLibraryTest, shouldEnumerateDescriptorsOfLoadedSuite)
+{
+    CxxSpec::SpecificationLibrary library(CXXSPEC_EXAMPLE_SUITE);
+    const CxxSpec::SpecificationDescriptors descriptors = library.specifications();
+
+    EXPECT_EQ("cxxspec-example", library.suite());
+    EXPECT_STREQ("cxxspec-example", descriptors.suite);
+    ASSERT_EQ(2, descriptors.last - descriptors.first);
+    EXPECT_STREQ("int", descriptors.first[0].description);
+    EXPECT_STREQ("std::vector<int>", descriptors.first[1].description);
+}
+
+TEST_F(SpecificationLibraryTest, shouldRunSuiteSpecificationsUnderSuiteName)
+{
+    CxxSpec::SpecificationLibrary library(CXXSPEC_EXAMPLE_SUITE);
+    CxxSpec::SpecificationRegistry registry;
+    registry.registerSpecifications(library.specifications());
+    auto observer = std::make_shared<NiceMock<SpecificationObserverMock>>();
+
+    EXPECT_CALL(*observer, testingSpecification("cxxspec-example: int"));
+    EXPECT_CALL(*observer, testingSpecification("cxxspec-example: std::vector<int>"));
+    EXPECT_CALL(*observer, testFailed(_)).Times(0);
+
+    registry.runAll([&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(observer); }, observer);
+}
+
+TEST_F(SpecificationLibraryTest, shouldRejectLibraryWithoutSpecificationEntry)
+{
+    EXPECT_THROW(CxxSpec::SpecificationLibrary("libm.so.6"), std::runtime_error);
+    EXPECT_THROW(CxxSpec::SpecificationLibrary("/nonexistent/libsuite.so"), std::runtime_error);
+}
@@ -25,8 +25,17 @@
 */
 
 #include <CxxSpec/SpecificationRegistry.hpp>
+#include <CxxSpec/ChangedFiles.hpp>
+#include <CxxSpec/DurationHistory.hpp>
+#include <CxxSpec/FailedLeaves.hpp>
+#include <CxxSpec/PerformanceCounterGroup.hpp>
+#include <CxxSpec/ResultCache.hpp>
 #include <iostream>
 #include <CxxSpec/ISpecificationObserver.hpp>
+#include <CxxSpec/MultiplexingSpecificationObserver.hpp>
+#include <CxxSpec/Specification.hpp>
+#include <set>
+#include <thread>
 #include <gmock/gmock.h>
 #include <SpecificationVisitorMock.hpp>
 #include "SpecificationObserverMock.hpp"
@@ -163,3 +172,327 @@ TEST_F(SpecificationRegistryTest, shouldNotifyObserverAboutSpecificationName)
 
     runAll();
 }
+
+TEST_F(SpecificationRegistryTest, shouldNotifyObserverAfterEachSpecificationFinished)
+{
+    registry.registerSpecification("spec1", &dummySpecification1);
+    registry.registerSpecification("spec2", &dummySpecification2);
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1))
+        .WillOnce(Return(visitor2));
+    {
+        InSequence seq;
+        EXPECT_CALL(*observer, testingSpecification("spec1"));
+        EXPECT_CALL(*observer, finishedSpecification());
+        EXPECT_CALL(*observer, testingSpecification("spec2"));
+        EXPECT_CALL(*observer, finishedSpecification());
+    }
+
+    runAll();
+}
+
+TEST_F(SpecificationRegistryTest, shouldReportTimingOfEachPassAndSpecification)
+{
+    registry.registerSpecification("spec1", &dummySpecification1);
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1));
+    EXPECT_CALL(*visitor1, done())
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+    {
+        InSequence seq;
+        EXPECT_CALL(*observer, leafTimed(_, _)).Times(2);
+        EXPECT_CALL(*observer, specificationTimed(_, _, 2));
+        EXPECT_CALL(*observer, finishedSpecification());
+        EXPECT_CALL(*observer, finishedRun());
+    }
+
+    runAll();
+}
+
+TEST_F(SpecificationRegistryTest, shouldNotMeasureCountersByDefault)
+{
+    registry.registerSpecification("spec1", &dummySpecification1);
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1));
+    EXPECT_CALL(*observer, leafCountersMeasured(_)).Times(0);
+    EXPECT_CALL(*observer, specificationCountersMeasured(_)).Times(0);
+
+    runAll();
+}
+
+TEST_F(SpecificationRegistryTest, shouldReportCountersOfEachPassAndTheirSumForSpecification)
+{
+    registry.registerSpecification("spec1", &dummySpecification1);
+    registry.measureCounters(&CxxSpec::openPerformanceCounters);
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1));
+    EXPECT_CALL(*visitor1, done())
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+    std::vector<CxxSpec::PerformanceCounters> leaves;
+    CxxSpec::PerformanceCounters total;
+    auto saveLeaf = [&](const CxxSpec::PerformanceCounters& counters) { leaves.push_back(counters); };
+    {
+        InSequence seq;
+        EXPECT_CALL(*observer, leafCountersMeasured(_))
+            .WillOnce(Invoke(saveLeaf));
+        EXPECT_CALL(*observer, leafTimed(_, _));
+        EXPECT_CALL(*observer, leafCountersMeasured(_))
+            .WillOnce(Invoke(saveLeaf));
+        EXPECT_CALL(*observer, leafTimed(_, _));
+        EXPECT_CALL(*observer, specificationCountersMeasured(_))
+            .WillOnce(SaveArg<0>(&total));
+        EXPECT_CALL(*observer, specificationTimed(_, _, 2));
+    }
+
+    runAll();
+
+    ASSERT_EQ(2u, leaves.size());
+    EXPECT_NE(CxxSpec::PerformanceCounters::Unavailable, total.source);
+    EXPECT_EQ(leaves[0].cpuTimeNanoseconds + leaves[1].cpuTimeNanoseconds, total.cpuTimeNanoseconds);
+    EXPECT_EQ(leaves[0].instructions + leaves[1].instructions, total.instructions);
+}
+
+TEST_F(SpecificationRegistryTest, shouldRunDescribedSpecificationsByFileAndLineBeforeRegisteredOnes)
+{
+    static const CxxSpec::SpecificationDescriptor descriptors[] = {
+        { "b.cpp:3", &dummySpecification1, "b.cpp", 3 },
+        { "a.cpp:9", &dummySpecification1, "a.cpp", 9 },
+        { "b.cpp:1", &dummySpecification1, "b.cpp", 1 }
+    };
+    const CxxSpec::SpecificationDescriptors range = { descriptors, descriptors + 3, nullptr };
+    registry.registerSpecifications(range);
+    registry.registerSpecification("registered", &dummySpecification1);
+
+    EXPECT_CALL(*this, visitorFactory())
+        .Times(4)
+        .WillRepeatedly(Return(visitor1));
+    {
+        InSequence seq;
+        EXPECT_CALL(*observer, testingSpecification("a.cpp:9"));
+        EXPECT_CALL(*observer, testingSpecification("b.cpp:1"));
+        EXPECT_CALL(*observer, testingSpecification("b.cpp:3"));
+        EXPECT_CALL(*observer, testingSpecification("registered"));
+    }
+
+    runAll();
+}
+
+TEST_F(SpecificationRegistryTest, shouldRunOnlySpecificationsMatchingSelectedTags)
+{
+    registry.registerSpecification("smoke", &dummySpecification1, CxxSpec::SourceLocation(), "smoke");
+    registry.registerSpecification("smoke io", &dummySpecification1, CxxSpec::SourceLocation(), "smoke io");
+    registry.registerSpecification("untagged", &dummySpecification1);
+    registry.selectTags("smoke & !io");
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1));
+    EXPECT_CALL(*observer, testingSpecification("smoke"));
+    EXPECT_CALL(*observer, finishedSpecification());
+
+    runAll();
+}
+
+TEST_F(SpecificationRegistryTest, shouldRunOnlySpecificationsDefinedInSelectedFiles)
+{
+    registry.registerSpecification("changed", &dummySpecification1, CxxSpec::SourceLocation("/src/changed.cpp", 3));
+    registry.registerSpecification("unchanged", &dummySpecification1, CxxSpec::SourceLocation("/src/unchanged.cpp", 3));
+    registry.registerSpecification("unknown location", &dummySpecification1);
+    registry.selectChangedFiles(CxxSpec::ChangedFileSelection({ "/src/changed.cpp" }));
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1));
+    EXPECT_CALL(*observer, testingSpecification("changed"));
+
+    runAll();
+}
+
+TEST_F(SpecificationRegistryTest, shouldReportLocationOfSpecification)
+{
+    registry.registerSpecification("spec1", &dummySpecification1, CxxSpec::SourceLocation("spec.cpp", 7));
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1));
+    std::string file;
+    unsigned line = 0;
+    struct LocationRecorder : SpecificationObserverMock
+    {
+        std::string *file;
+        unsigned *line;
+
+        virtual void testingSpecificationAt(const std::string& , const CxxSpec::SourceLocation& location)
+        {
+            *file = location.file;
+            *line = location.line;
+        }
+    };
+    auto recorder = std::make_shared<NiceMock<LocationRecorder>>();
+    recorder->file = &file;
+    recorder->line = &line;
+
+    registry.runAll([&]{ return visitorFactory(); }, recorder);
+
+    EXPECT_EQ("spec.cpp", file);
+    EXPECT_EQ(7u, line);
+}
+
+TEST_F(SpecificationRegistryTest, shouldReportSpecificationsWhichPassedBeforeAsCached)
+{
+    char path[] = "/tmp/cxxspec-cache-XXXXXX";
+    const std::string directory = ::mkdtemp(path);
+    registry.cacheResults(std::make_shared<CxxSpec::ResultCache>(directory));
+    registry.registerSpecification("passing", &dummySpecification1);
+    registry.registerSpecification("failing", &specificationWithError1);
+    EXPECT_CALL(*this, visitorFactory())
+        .WillRepeatedly(Return(visitor1));
+    runAll();
+    dummySpecification1Called = false;
+
+    EXPECT_CALL(*observer, testingSpecification("passing"));
+    EXPECT_CALL(*observer, specificationCached());
+    EXPECT_CALL(*observer, testingSpecification("failing"));
+    EXPECT_CALL(*observer, testFailed(_));
+
+    runAll();
+
+    EXPECT_FALSE(dummySpecification1Called);
+    std::system(("rm -rf " + CxxSpec::Detail::shellQuoted(directory)).c_str());
+}
+
+TEST_F(SpecificationRegistryTest, shouldRunRecordedLeavesFirstDrivenDownTheirContexts)
+{
+    registry.registerSpecification("first", &dummySpecification1);
+    registry.registerSpecification("failed", &dummySpecification2);
+    const CxxSpec::RecordedLeaf leaf = { "failed", { "when empty", "should throw" } };
+    registry.runLeavesFirst(CxxSpec::RecordedLeaves(1, leaf), false);
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1))
+        .WillRepeatedly(Return(visitor2));
+    EXPECT_CALL(*visitor1, selectPath(ElementsAre("when empty", "should throw")));
+    EXPECT_CALL(*visitor2, selectPath(_)).Times(0);
+    {
+        InSequence s;
+        EXPECT_CALL(*observer, testingSpecification("failed"));
+        EXPECT_CALL(*observer, specificationNarrowedToLeaf());
+        EXPECT_CALL(*observer, testingSpecification("first"));
+        EXPECT_CALL(*observer, testingSpecification("failed"));
+    }
+
+    runAll();
+}
+
+TEST_F(SpecificationRegistryTest, shouldRunOnlyRecordedLeavesOfRegisteredSpecifications)
+{
+    registry.registerSpecification("first", &dummySpecification1);
+    registry.registerSpecification("failed", &dummySpecification2);
+    const CxxSpec::RecordedLeaf leaves[] = { { "failed", { "when empty" } }, { "removed", { } } };
+    registry.runLeavesFirst(CxxSpec::RecordedLeaves(leaves, leaves + 2), true);
+    dummySpecification1Called = false;
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1));
+    EXPECT_CALL(*observer, testingSpecification("failed"));
+    EXPECT_CALL(*observer, finishedSpecification());
+
+    runAll();
+
+    EXPECT_FALSE(dummySpecification1Called);
+}
+
+TEST_F(SpecificationRegistryTest, shouldStartSpecificationsExpectedToTakeLongestFirst)
+{
+    registry.registerSpecification("short", &dummySpecification1);
+    registry.registerSpecification("new", &dummySpecification1);
+    registry.registerSpecification("long", &dummySpecification1);
+    auto history = std::make_shared<CxxSpec::DurationHistory>();
+    CxxSpec::DurationHistory::Durations durations;
+    durations.specification = 10;
+    history->record("short", durations);
+    durations.leaves[""] = 30;
+    durations.specification = 60;
+    history->record("long", durations);
+    registry.scheduleLongestFirst(history);
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillRepeatedly(Return(visitor1));
+    {
+        InSequence s;
+        EXPECT_CALL(*observer, testingSpecification("long"));
+        EXPECT_CALL(*observer, testingSpecification("new"));
+        EXPECT_CALL(*observer, testingSpecification("short"));
+    }
+
+    runAll();
+}
+
+TEST_F(SpecificationRegistryTest, shouldRunEverySpecificationOnceOnAllJobs)
+{
+    struct SpecificationCounter : CxxSpec::ISpecificationObserver
+    {
+        std::multiset<std::string> specs;
+
+        virtual void testFailed(const CxxSpec::AssertionFailed& ) { }
+        virtual void testingSpecification(const std::string& spec) { specs.insert(spec); }
+        virtual void enteredContext(const std::string& ) { }
+        virtual void leftContext() { }
+    };
+    struct Slow
+    {
+        static void specification(CxxSpec::ISpecificationVisitor& CxxSpec_specificationVisitor)
+        {
+            CxxSpec::SpecificationGuard guard(CxxSpec_specificationVisitor);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            CXXSPEC_CONTEXT("a") { }
+            CXXSPEC_CONTEXT("b") { }
+        }
+    };
+    for (int i = 0; i != 16; ++i)
+        registry.registerSpecification("spec " + std::to_string(i), &Slow::specification);
+    registry.runJobs(4);
+    auto counter = std::make_shared<SpecificationCounter>();
+    auto so = std::make_shared<CxxSpec::MultiplexingSpecificationObserver>();
+    so->add(counter);
+
+    registry.runAll([&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(so); }, so);
+
+    EXPECT_EQ(16u, counter->specs.size());
+    for (int i = 0; i != 16; ++i)
+        EXPECT_EQ(1u, counter->specs.count("spec " + std::to_string(i)));
+}
+
+TEST_F(SpecificationRegistryTest, shouldStartNoSpecificationAfterTimeBudgetAndReportRestAsSkipped)
+{
+    struct Slow
+    {
+        static void specification(CxxSpec::ISpecificationVisitor& )
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    };
+    registry.registerSpecification("unlikely", &Slow::specification);
+    registry.registerSpecification("likely", &Slow::specification);
+    registry.prioritize([](const std::string& description, const CxxSpec::SourceLocation& )
+    {
+        return description == "likely" ? 1.0 : 0.0;
+    });
+    registry.limitTime(std::chrono::milliseconds(10));
+
+    EXPECT_CALL(*this, visitorFactory())
+        .WillOnce(Return(visitor1));
+    {
+        InSequence s;
+        EXPECT_CALL(*observer, testingSpecification("likely"));
+        EXPECT_CALL(*observer, finishedSpecification());
+        EXPECT_CALL(*observer, testingSpecification("unlikely"));
+        EXPECT_CALL(*observer, specificationSkipped());
+        EXPECT_CALL(*observer, finishedSpecification());
+    }
+
+    runAll();
+}
@@ -0,0 +1,206 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/StringDiff.hpp>
+#include <CxxSpec/Assert.hpp>
+#include <sstream>
+#include <gtest/gtest.h>
+
+class Lines
+{
+public:
+    explicit Lines(const std::string& text) : text(text) { }
+
+    friend bool operator==(const std::string& left, const Lines& right) { return left == right.text; }
+    friend std::ostream& operator<<(std::ostream& os, const Lines& lines) { return os << lines.text; }
+private:
+    std::string text;
+};
+
+struct StringDiffTest : testing::Test
+{
+    static std::string numberedLines(int count)
+    {
+        std::ostringstream os;
+        for (int i = 1; i <= count; ++i)
+            os << "line " << i << "\n";
+        return os.str();
+    }
+
+    static std::string replaceLine(std::string text, int number, const std::string& replacement)
+    {
+        std::ostringstream line;
+        line << "line " << number << "\n";
+        return text.replace(text.find(line.str()), line.str().size(), replacement + "\n");
+    }
+};
+
+TEST_F(StringDiffTest, shouldDiffOnlyStringsWithMultipleOrLongLines)
+{
+    ASSERT_FALSE(CxxSpec::StringDiff::isWorthDiffing("abc", "abd"));
+    ASSERT_TRUE(CxxSpec::StringDiff::isWorthDiffing("a\nb", "a"));
+    ASSERT_TRUE(CxxSpec::StringDiff::isWorthDiffing(std::string(200, 'a'), "a"));
+}
+
+TEST_F(StringDiffTest, shouldReportChangedLineWithCharacterGuides)
+{
+    ASSERT_EQ(
+        "--- expected\n+++ actual\n"
+        "@@ -1,3 +1,3 @@\n"
+        " first\n"
+        "-second\n"
+        "?  ^\n"
+        "+seXond\n"
+        "?  ^\n"
+        " third",
+        CxxSpec::StringDiff("first\nsecond\nthird", "first\nseXond\nthird").str());
+}
+
+TEST_F(StringDiffTest, shouldMarkOnlyInsertedCharactersInActualLine)
+{
+    ASSERT_EQ(
+        "--- expected\n+++ actual\n"
+        "@@ -1,1 +1,1 @@\n"
+        "-abcdef\n"
+        "+abc123def\n"
+        "?   ^^^",
+        CxxSpec::StringDiff("abcdef", "abc123def").str());
+}
+
+TEST_F(StringDiffTest, shouldReportInsertedAndDeletedLines)
+{
+    ASSERT_EQ(
+        "--- expected\n+++ actual\n"
+        "@@ -1,3 +1,3 @@\n"
+        " a\n"
+        "-b\n"
+        " c\n"
+        "+d",
+        CxxSpec::StringDiff("a\nb\nc", "a\nc\nd").str());
+}
+
+TEST_F(StringDiffTest, shouldLimitOutputToChangedHunksWithContext)
+{
+    std::string expected = numberedLines(100);
+    std::string actual = replaceLine(replaceLine(expected, 20, "changed 20"), 80, "changed 80");
+    ASSERT_EQ(
+        "--- expected\n+++ actual\n"
+        "@@ -17,7 +17,7 @@\n"
+        " line 17\n line 18\n line 19\n"
+        "-line 20\n?^^\n+changed 20\n?^^^ ^ ^\n"
+        " line 21\n line 22\n line 23\n"
+        "@@ -77,7 +77,7 @@\n"
+        " line 77\n line 78\n line 79\n"
+        "-line 80\n?^^\n+changed 80\n?^^^ ^ ^\n"
+        " line 81\n line 82\n line 83",
+        CxxSpec::StringDiff(expected, actual).str());
+}
+
+TEST_F(StringDiffTest, shouldTruncateReportAfterTooManyHunks)
+{
+    std::string expected = numberedLines(1000);
+    std::string actual = expected;
+    for (int i = 10; i <= 1000; i += 10)
+        actual = replaceLine(actual, i, "x");
+    std::string diff = CxxSpec::StringDiff(expected, actual).str();
+    ASSERT_NE(std::string::npos, diff.find("\n... 90 more differences"));
+    ASSERT_EQ(std::string::npos, diff.find("line 110\n"));
+}
+
+TEST_F(StringDiffTest, shouldShowExcerptAroundDifferenceInLongLines)
+{
+    std::string expected(10000, 'a'), actual = expected;
+    actual[5000] = 'b';
+    std::string excerpt = "..." + std::string(30, 'a');
+    ASSERT_EQ(
+        "--- expected\n+++ actual\n"
+        "@@ -1,1 +1,1 @@\n"
+        "-" + excerpt + "a" + std::string(30, 'a') + "...\n"
+        "?" + std::string(33, ' ') + "^\n"
+        "+" + excerpt + "b" + std::string(30, 'a') + "...\n"
+        "?" + std::string(33, ' ') + "^",
+        CxxSpec::StringDiff(expected, actual).str());
+}
+
+TEST_F(StringDiffTest, shouldStayBoundedForLargeCompletelyDifferentInputs)
+{
+    std::ostringstream expected, actual;
+    for (int i = 0; i < 100000; ++i)
+    {
+        expected << "expected " << i << "\n";
+        actual << "actual " << (i * 7) << "\n";
+    }
+    std::string diff = CxxSpec::StringDiff(expected.str(), actual.str()).str();
+    ASSERT_EQ(0u, diff.find("--- expected\n+++ actual\n@@ -1,100001 +1,100001 @@\n"));
+}
+
+TEST_F(StringDiffTest, shouldBeUsedForFailedEqualityOfMultilineStrings)
+{
+    try
+    {
+        CXXSPEC_EXPECT(std::string("a\nb")).should == std::string("a\nc");
+        FAIL() << "expected AssertionFailed";
+    }
+    catch (const CxxSpec::AssertionFailed& af)
+    {
+        EXPECT_EQ(
+            "expected to equal the expected string but differs:\n"
+            "--- expected\n+++ actual\n"
+            "@@ -1,2 +1,2 @@\n"
+            " a\n"
+            "-c\n"
+            "?^\n"
+            "+b\n"
+            "?^",
+            af.expectation());
+    }
+}
+
+TEST_F(StringDiffTest, shouldPrintShortSingleLineStringsAsAWhole)
+{
+    try
+    {
+        CXXSPEC_EXPECT(std::string("abc")).should == std::string("abd");
+        FAIL() << "expected AssertionFailed";
+    }
+    catch (const CxxSpec::AssertionFailed& af)
+    {
+        EXPECT_EQ("expected to equal abd but equals abc", af.expectation());
+    }
+}
+
+TEST_F(StringDiffTest, shouldPrintExpectedValuesThatAreNotStrings)
+{
+    try
+    {
+        CXXSPEC_EXPECT(std::string("a\nb")).should == Lines("a\nc");
+        FAIL() << "expected AssertionFailed";
+    }
+    catch (const CxxSpec::AssertionFailed& af)
+    {
+        EXPECT_EQ(0u, af.expectation().find("expected to equal the expected string but differs:\n"));
+    }
+}
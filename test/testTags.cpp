@@ -0,0 +1,83 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/Tags.hpp>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+struct TagsTest : testing::Test
+{
+    static bool matches(const char *query, const char *tags)
+    {
+        return CxxSpec::TagQuery(query).matches(CxxSpec::parseTags(tags));
+    }
+};
+
+TEST_F(TagsTest, shouldAssignSameBitToSameTag)
+{
+    const CxxSpec::TagSet tags = CxxSpec::parseTags("slow, io");
+    EXPECT_EQ(2u, tags.count());
+    EXPECT_EQ(tags, CxxSpec::parseTags(" io slow "));
+    EXPECT_TRUE(CxxSpec::parseTags("").none());
+    EXPECT_TRUE(CxxSpec::parseTags(nullptr).none());
+}
+
+TEST_F(TagsTest, shouldMatchEverythingWithEmptyQuery)
+{
+    EXPECT_TRUE(matches("", ""));
+    EXPECT_TRUE(matches("  ", "slow"));
+}
+
+TEST_F(TagsTest, shouldEvaluateOperators)
+{
+    EXPECT_TRUE(matches("smoke", "smoke io"));
+    EXPECT_FALSE(matches("smoke", "io"));
+    EXPECT_TRUE(matches("smoke & !io", "smoke"));
+    EXPECT_FALSE(matches("smoke & !io", "smoke io"));
+    EXPECT_TRUE(matches("slow | io", "io"));
+    EXPECT_FALSE(matches("slow | io", "smoke"));
+    EXPECT_TRUE(matches("!flaky", ""));
+}
+
+TEST_F(TagsTest, shouldNegateGroupedExpressions)
+{
+    EXPECT_TRUE(matches("!(slow & io)", "slow"));
+    EXPECT_FALSE(matches("!(slow & io)", "slow io"));
+    EXPECT_TRUE(matches("!(slow | !io)", "io"));
+    EXPECT_FALSE(matches("!(slow | !io)", "slow io"));
+    EXPECT_FALSE(matches("!(slow | !io)", ""));
+    EXPECT_TRUE(matches("(smoke | slow) & !(io & flaky)", "slow io"));
+    EXPECT_FALSE(matches("(smoke | slow) & !(io & flaky)", "slow io flaky"));
+    EXPECT_FALSE(matches("smoke & !smoke", "smoke"));
+    EXPECT_TRUE(matches("!!smoke", "smoke"));
+}
+
+TEST_F(TagsTest, shouldRejectInvalidQuery)
+{
+    EXPECT_THROW(CxxSpec::TagQuery("smoke &"), std::invalid_argument);
+    EXPECT_THROW(CxxSpec::TagQuery("(smoke"), std::invalid_argument);
+    EXPECT_THROW(CxxSpec::TagQuery("smoke io"), std::invalid_argument);
+}
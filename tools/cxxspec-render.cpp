@@ -0,0 +1,174 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/BinaryEventLog.hpp>
+#include <CxxSpec/ConsoleSpecificationObserver.hpp>
+#include <CxxSpec/JUnitSpecificationObserver.hpp>
+#include <CxxSpec/Json.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+class JsonRenderer
+{
+public:
+    explicit JsonRenderer(std::ostream& os) : os(os), first(true)
+    {
+        os << "[";
+    }
+
+    ~JsonRenderer()
+    {
+        os << "\n]\n";
+    }
+
+    void specificationStarted(const std::string& spec)
+    {
+        begin("specification");
+        os << ", \"name\": ";
+        CxxSpec::Detail::writeJsonString(os, spec);
+        os << "}";
+    }
+
+    void enteredContext(const std::string& context)
+    {
+        begin("enteredContext");
+        os << ", \"name\": ";
+        CxxSpec::Detail::writeJsonString(os, context);
+        os << "}";
+    }
+
+    void leftContext()
+    {
+        begin("leftContext");
+        os << "}";
+    }
+
+    void failed(const CxxSpec::AssertionFailed& af)
+    {
+        begin("failure");
+        os << ", \"file\": ";
+        CxxSpec::Detail::writeJsonString(os, af.file());
+        os << ", \"line\": " << af.line() << ", \"expression\": ";
+        CxxSpec::Detail::writeJsonString(os, af.expression());
+        os << ", \"expectation\": ";
+        CxxSpec::Detail::writeJsonString(os, af.expectation());
+        os << "}";
+    }
+
+    void sectionTimed(const std::string& context, CxxSpec::Timestamp start, CxxSpec::Timestamp end, unsigned entries)
+    {
+        begin("sectionTimed");
+        os << ", \"context\": ";
+        CxxSpec::Detail::writeJsonString(os, context);
+        interval(start, end);
+        os << ", \"entries\": " << entries << "}";
+    }
+
+    void leafTimed(CxxSpec::Timestamp start, CxxSpec::Timestamp end)
+    {
+        begin("leafTimed");
+        interval(start, end);
+        os << "}";
+    }
+
+    void specificationTimed(CxxSpec::Timestamp start, CxxSpec::Timestamp end, unsigned passes)
+    {
+        begin("specificationTimed");
+        interval(start, end);
+        os << ", \"passes\": " << passes << "}";
+    }
+
+    void allocationsMeasured(const CxxSpec::AllocationStatistics& allocated)
+    {
+        begin("allocations");
+        os << ", \"allocations\": " << allocated.allocations << ", \"bytes\": " << allocated.bytes << "}";
+    }
+
+private:
+    std::ostream& os;
+    bool first;
+
+    void interval(CxxSpec::Timestamp start, CxxSpec::Timestamp end)
+    {
+        os << ", \"start\": " << CxxSpec::Detail::nanosecondsSinceEpoch(start)
+            << ", \"end\": " << CxxSpec::Detail::nanosecondsSinceEpoch(end);
+    }
+
+    void begin(const char *event)
+    {
+        os << (first ? "\n  " : ",\n  ") << "{\"event\": \"" << event << "\"";
+        first = false;
+    }
+};
+
+int usage()
+{
+    std::cerr << "usage: cxxspec-render console|json|junit LOG [FIRST [COUNT]]\n";
+    return 2;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3 || argc > 5)
+        return usage();
+    const std::string format = argv[1];
+    const std::size_t first = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+    const std::size_t count = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : CxxSpec::BinaryEventLog::all;
+    try
+    {
+        CxxSpec::MappedFile file(argv[2]);
+        CxxSpec::BinaryEventLog log(file.data(), file.size());
+        if (format == "console")
+        {
+            CxxSpec::ConsoleSpecificationObserver console(std::cout);
+            log.replay(console, first, count);
+        }
+        else if (format == "junit")
+        {
+            CxxSpec::JUnitSpecificationObserver junit(std::cout);
+            log.replay(junit, first, count);
+        }
+        else if (format == "json")
+        {
+            JsonRenderer json(std::cout);
+            log.visit(json, first, count);
+        }
+        else
+            return usage();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "cxxspec-render: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,343 @@
+/*
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <CxxSpec/ChangedFiles.hpp>
+#include <CxxSpec/ConsoleSpecificationObserver.hpp>
+#include <CxxSpec/CoverageHooks.hpp>
+#include <CxxSpec/DurationHistory.hpp>
+#include <CxxSpec/FailedLeaves.hpp>
+#include <CxxSpec/FileWatcher.hpp>
+#include <CxxSpec/MultiplexingSpecificationObserver.hpp>
+#include <CxxSpec/RegressionLikelihood.hpp>
+#include <CxxSpec/ResultChanges.hpp>
+#include <CxxSpec/SpecificationHost.hpp>
+#include <CxxSpec/SpecificationLibrary.hpp>
+#include <CxxSpec/SpecificationRegistry.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class RunCounter : public CxxSpec::ISpecificationObserver
+{
+public:
+    RunCounter() : failures(0), skipped(0) { }
+
+    virtual void testFailed(const CxxSpec::AssertionFailed& ) { ++failures; }
+    virtual void testingSpecification(const std::string& ) { }
+    virtual void enteredContext(const std::string& ) { }
+    virtual void leftContext() { }
+    virtual void specificationSkipped() { ++skipped; }
+
+    unsigned failures, skipped;
+};
+
+struct Options
+{
+    bool list, failuresFirst, failuresOnly;
+    unsigned jobs;
+    double budget;
+    std::vector<std::string> suites, paths, changed, dependencyFiles, watched, inputs;
+    std::string tags, range, cache, recordedCoverage, coverageMap, diff, failures, history;
+
+    Options() : list(false), failuresFirst(false), failuresOnly(false), jobs(1), budget(0) { }
+};
+
+int usage()
+{
+    std::cerr <<
+        "usage: cxxspec-run [--list] [--suite NAME]... [--tags QUERY]\n"
+        "                   [--changed FILE]... [--git-range RANGE] [--dependencies FILE]...\n"
+        "                   [--watch DIRECTORY]... [--cache DIRECTORY [--input FILE]...]\n"
+        "                   [--record-coverage MAP] [--select-covered MAP [--diff FILE]]\n"
+        "                   [--failures FILE [--failures-first | --failures-only]]\n"
+        "                   [--jobs N] [--history FILE] [--budget SECONDS] LIBRARY...\n";
+    return 2;
+}
+
+CxxSpec::ChangedFileSelection changedFileSelection(const std::vector<std::string>& changed, const std::vector<std::string>& dependencyFiles)
+{
+    CxxSpec::ChangedFileSelection selection(changed);
+    for (const std::string& path : dependencyFiles)
+    {
+        std::ifstream rules(path.c_str());
+        if (!rules)
+            throw std::runtime_error("cannot open " + path);
+        selection.readDependencies(rules);
+    }
+    return selection;
+}
+
+// The failing leaves are kept in the failures file between runs, so the
+// leaves which failed last can be run before the rest, or alone. The
+// durations and outcomes are kept in the history file, so a parallel run
+// can start the longest specifications first, and a run with a time budget
+// those most likely to find a regression, counting the specifications in
+// the changed files as likely.
+unsigned runSpecifications(
+    CxxSpec::SpecificationRegistry& registry, const Options& options, CxxSpec::RunResults& results,
+    std::shared_ptr<const CxxSpec::ChangedFileSelection> changed = nullptr)
+{
+    auto counter = std::make_shared<RunCounter>();
+    auto recorder = std::make_shared<CxxSpec::ResultRecorder>();
+    auto leaves = std::make_shared<CxxSpec::FailedLeafRecorder>();
+    auto durations = std::make_shared<CxxSpec::DurationRecorder>();
+    auto so = std::make_shared<CxxSpec::MultiplexingSpecificationObserver>();
+    so->add(std::make_shared<CxxSpec::ConsoleSpecificationObserver>(std::cout));
+    so->add(counter);
+    so->add(recorder);
+    CxxSpec::RecordedLeaves previous;
+    if (!options.failures.empty())
+    {
+        previous = CxxSpec::loadFailedLeaves(options.failures);
+        so->add(leaves);
+        if (options.failuresFirst || options.failuresOnly)
+            registry.runLeavesFirst(previous, options.failuresOnly);
+    }
+    auto history = std::make_shared<CxxSpec::DurationHistory>();
+    if (!options.history.empty())
+    {
+        *history = CxxSpec::DurationHistory::load(options.history);
+        so->add(durations);
+    }
+    if (options.budget > 0)
+    {
+        registry.limitTime(std::chrono::duration_cast<CxxSpec::TimingClock::duration>(std::chrono::duration<double>(options.budget)));
+        registry.prioritize(CxxSpec::RegressionLikelihood(history, changed));
+    }
+    else if (!options.history.empty() && options.jobs > 1)
+        registry.scheduleLongestFirst(history);
+    registry.runAll([&]{ return std::make_shared<CxxSpec::SpecificationExecutor>(so); }, so);
+    results = recorder->results();
+    if (!options.failures.empty())
+        CxxSpec::saveFailedLeaves(options.failures, leaves->merged(previous));
+    if (!options.history.empty())
+    {
+        history->update(durations->recorded());
+        history->save(options.history);
+    }
+    if (counter->skipped)
+        std::cout << "cxxspec-run: " << counter->skipped << " specifications skipped after the time budget" << std::endl;
+    return counter->failures;
+}
+
+// Runs in one process until interrupted. Rebuilt libraries are reloaded
+// and all specifications are run, otherwise only the specifications in the
+// changed sources, or in sources including them according to the
+// dependency files, are run. Each run is compared with the last results of
+// the same specifications.
+void watch(const Options& options, const std::vector<std::string>& paths, CxxSpec::SpecificationRegistry& registry)
+{
+    CxxSpec::SpecificationHost host(registry);
+    CxxSpec::FileWatcher watcher;
+    for (const std::string& path : paths)
+    {
+        host.load(path);
+        watcher.watchFile(path);
+    }
+    for (const std::string& directory : options.watched)
+        watcher.watchDirectory(directory);
+    CxxSpec::RunResults results;
+    runSpecifications(registry, options, results);
+    for (;;)
+    {
+        std::cout << "cxxspec-run: watching for changes" << std::endl;
+        const std::vector<std::string> changes = watcher.waitForChanges(std::chrono::milliseconds(200));
+        bool rebuilt = false;
+        for (const std::string& path : host.changedLibraries())
+        {
+            try
+            {
+                host.reload(path);
+                rebuilt = true;
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "cxxspec-run: " << e.what() << "\n";
+            }
+        }
+        if (rebuilt)
+            registry.selectAllFiles();
+        else
+            registry.selectChangedFiles(changedFileSelection(changes, options.dependencyFiles));
+        CxxSpec::RunResults current;
+        runSpecifications(registry, options, current);
+        CxxSpec::printResultChanges(std::cout, CxxSpec::compareResults(results, current));
+        if (rebuilt)
+            results = current;
+        else
+            for (const auto& spec : current)
+                results[spec.first] = spec.second;
+    }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--list")
+            options.list = true;
+        else if (arg == "--suite" && i + 1 < argc)
+            options.suites.push_back(argv[++i]);
+        else if (arg == "--tags" && i + 1 < argc)
+            options.tags = argv[++i];
+        else if (arg == "--changed" && i + 1 < argc)
+            options.changed.push_back(argv[++i]);
+        else if (arg == "--git-range" && i + 1 < argc)
+            options.range = argv[++i];
+        else if (arg == "--dependencies" && i + 1 < argc)
+            options.dependencyFiles.push_back(argv[++i]);
+        else if (arg == "--watch" && i + 1 < argc)
+            options.watched.push_back(argv[++i]);
+        else if (arg == "--cache" && i + 1 < argc)
+            options.cache = argv[++i];
+        else if (arg == "--input" && i + 1 < argc)
+            options.inputs.push_back(argv[++i]);
+        else if (arg == "--record-coverage" && i + 1 < argc)
+            options.recordedCoverage = argv[++i];
+        else if (arg == "--select-covered" && i + 1 < argc)
+            options.coverageMap = argv[++i];
+        else if (arg == "--diff" && i + 1 < argc)
+            options.diff = argv[++i];
+        else if (arg == "--failures" && i + 1 < argc)
+            options.failures = argv[++i];
+        else if (arg == "--failures-first")
+            options.failuresFirst = true;
+        else if (arg == "--failures-only")
+            options.failuresOnly = true;
+        else if (arg == "--jobs" && i + 1 < argc)
+            options.jobs = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--history" && i + 1 < argc)
+            options.history = argv[++i];
+        else if (arg == "--budget" && i + 1 < argc)
+        {
+            options.budget = std::strtod(argv[++i], nullptr);
+            if (!(options.budget > 0))
+                return usage();
+        }
+        else if (arg.compare(0, 2, "--") == 0)
+            return usage();
+        else
+            options.paths.push_back(arg);
+    }
+    if (options.paths.empty() || options.jobs == 0 || ((options.failuresFirst || options.failuresOnly) && options.failures.empty()))
+        return usage();
+    try
+    {
+        CxxSpec::SpecificationRegistry registry;
+        if (!options.tags.empty())
+            registry.selectTags(options.tags);
+        registry.runJobs(options.jobs);
+        if (!options.cache.empty())
+        {
+            auto cache = std::make_shared<CxxSpec::ResultCache>(options.cache);
+            for (const std::string& input : options.inputs)
+                cache->declareInput(input);
+            registry.cacheResults(cache);
+        }
+        if (!options.coverageMap.empty())
+        {
+            std::vector<CxxSpec::ChangedLines> changes;
+            if (!options.range.empty())
+                changes = CxxSpec::changedLinesInGitRange(options.range);
+            if (!options.diff.empty())
+            {
+                std::ifstream is(options.diff.c_str());
+                if (!is)
+                    throw std::runtime_error("cannot open " + options.diff);
+                std::vector<std::string> lines;
+                for (std::string line; std::getline(is, line); )
+                    lines.push_back(line);
+                const std::vector<CxxSpec::ChangedLines> inDiff = CxxSpec::parseUnifiedDiff(lines);
+                changes.insert(changes.end(), inDiff.begin(), inDiff.end());
+            }
+            registry.selectCoverageImpact(CxxSpec::CoverageMap(options.coverageMap).impact(changes));
+            options.range.clear();
+        }
+        std::shared_ptr<CxxSpec::CoverageCollector> coverage;
+        if (!options.recordedCoverage.empty())
+        {
+            coverage = std::make_shared<CxxSpec::CoverageCollector>();
+            registry.collectCoverage(coverage);
+        }
+        if (!options.range.empty())
+        {
+            const std::vector<std::string> inRange = CxxSpec::changedFilesInGitRange(options.range);
+            options.changed.insert(options.changed.end(), inRange.begin(), inRange.end());
+        }
+        std::shared_ptr<const CxxSpec::ChangedFileSelection> changed;
+        if ((!options.changed.empty() || !options.range.empty()) && options.budget > 0)
+            changed = std::make_shared<CxxSpec::ChangedFileSelection>(changedFileSelection(options.changed, options.dependencyFiles));
+        else if (!options.changed.empty() || !options.range.empty())
+            registry.selectChangedFiles(changedFileSelection(options.changed, options.dependencyFiles));
+        std::vector<std::string> paths;
+        for (const std::string& path : options.paths)
+        {
+            const std::string suite = CxxSpec::SpecificationLibrary::suiteName(path);
+            if (options.suites.empty() || std::find(options.suites.begin(), options.suites.end(), suite) != options.suites.end())
+                paths.push_back(path);
+        }
+        if (!options.watched.empty() && !options.list)
+            watch(options, paths, registry);
+        std::vector<std::unique_ptr<CxxSpec::SpecificationLibrary>> libraries;
+        for (const std::string& path : paths)
+        {
+            libraries.emplace_back(new CxxSpec::SpecificationLibrary(path));
+            registry.registerSpecifications(libraries.back()->specifications());
+        }
+        if (options.list)
+        {
+            for (const auto& library : libraries)
+            {
+                const CxxSpec::SpecificationDescriptors descriptors = library->specifications();
+                for (const CxxSpec::SpecificationDescriptor *descriptor = descriptors.first; descriptor != descriptors.last; ++descriptor)
+                    std::cout << library->suite() << ": " << descriptor->description << "\n";
+            }
+            return 0;
+        }
+        CxxSpec::RunResults results;
+        const unsigned failures = runSpecifications(registry, options, results, changed);
+        if (coverage)
+            coverage->save(options.recordedCoverage);
+        return failures == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "cxxspec-run: " << e.what() << "\n";
+        return 1;
+    }
+}